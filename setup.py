@@ -63,6 +63,7 @@ setup(
     description="""Simulation module for spreading processes on networks 
     using pybind11 and CMake""",
     long_description='',
+    install_requires=['numpy'],
     ext_modules=[CMakeExtension('spreading_CR')],
     cmdclass=dict(build_ext=CMakeBuild),
     zip_safe=False,
@@ -64,13 +64,19 @@ BinaryTree::BinaryTree(unsigned int n_leaves) :
     }
 }
 
-//Copy constructor of the class BinaryTree
+//Copy constructor of the class BinaryTree; every node gets the value of the
+//same node in tree, so that the copy samples exactly like the original
 BinaryTree::BinaryTree(const BinaryTree& tree) :
     root_(nullptr),
     current_node_(nullptr),
     leaves_vector_(),
     leaves_index_map_()
 {
+    if (tree.root_ == nullptr)
+    {
+        return;
+    }
+
     //Construct a new tree with n_leaves
     unsigned int n_leaves = tree.leaves_vector_.size();
     BinaryTreeNode* root = new BinaryTreeNode;
@@ -81,43 +87,49 @@ BinaryTree::BinaryTree(const BinaryTree& tree) :
     root->child_left = branch(root, 1, n_nodes);
     root->child_right = branch(root, 2, n_nodes);
 
-    //Give the same values to the leaves
-    LeafIndex leaf_index = 0;
-    for (auto iter = tree.leaves_vector_.begin();
-        iter != tree.leaves_vector_.end(); ++iter)
-    {
-        update_value(leaf_index, (*iter)->value);
-        leaf_index += 1;
-    }
+    //Give the same values to all the nodes; summing the leaves again could
+    //round the internal nodes differently
+    set_value_vector(tree.get_value_vector());
+}
+
+//Move constructor of the class BinaryTree; the nodes are taken from tree
+BinaryTree::BinaryTree(BinaryTree&& tree) noexcept :
+    root_(tree.root_),
+    current_node_(tree.current_node_),
+    leaves_vector_(move(tree.leaves_vector_)),
+    leaves_index_map_(move(tree.leaves_index_map_))
+{
+    tree.root_ = nullptr;
+    tree.current_node_ = nullptr;
+    tree.leaves_vector_.clear();
+    tree.leaves_index_map_.clear();
 }
 
 //Overload the assignement operator
 BinaryTree& BinaryTree::operator=(const BinaryTree& tree)
 {
-    //destroy the current tree
-    this->destroy_tree(root_);
-    this->leaves_vector_.clear();
-    this->leaves_index_map_.clear();
-
-    //Construct a new tree with n_leaves
-    unsigned int n_leaves = tree.leaves_vector_.size();
-    BinaryTreeNode* root = new BinaryTreeNode;
-    root_ = root;
-    current_node_ = root; //assign current node to the root
-    unsigned int n_nodes = 2*n_leaves - 1; //number of nodes for
-                                           //a full binary tree
-    root->child_left = branch(root, 1, n_nodes);
-    root->child_right = branch(root, 2, n_nodes);
-
-    //Give the same values to the leaves
-    LeafIndex leaf_index = 0;
-    for (auto iter = tree.leaves_vector_.begin();
-        iter != tree.leaves_vector_.end(); ++iter)
+    if (this != &tree)
     {
-        update_value(leaf_index, (*iter)->value);
-        leaf_index += 1;
+        *this = BinaryTree(tree);
     }
+    return *this;
+}
 
+//Overload the move assignement operator
+BinaryTree& BinaryTree::operator=(BinaryTree&& tree) noexcept
+{
+    if (this != &tree)
+    {
+        destroy_tree(root_);
+        root_ = tree.root_;
+        current_node_ = tree.current_node_;
+        leaves_vector_ = move(tree.leaves_vector_);
+        leaves_index_map_ = move(tree.leaves_index_map_);
+        tree.root_ = nullptr;
+        tree.current_node_ = nullptr;
+        tree.leaves_vector_.clear();
+        tree.leaves_index_map_.clear();
+    }
     return *this;
 }
 
@@ -149,6 +161,14 @@ LeafIndex BinaryTree::get_leaf_index(double r)
     return chosen_leaf;
 }
 
+//Get the value of all nodes (preorder)
+vector<double> BinaryTree::get_value_vector() const
+{
+    vector<double> value_vector;
+    get_subtree_values(root_, value_vector);
+    return value_vector;
+}
+
 //Recursive method to construct a full binary tree
 BinaryTreeNode* BinaryTree::branch(BinaryTreeNode* parent, int node_index,
     int n_nodes)
@@ -235,6 +255,39 @@ void BinaryTree::update_zero()
     }
 }
 
+//Set the value of all nodes (preorder), as given by get_value_vector
+void BinaryTree::set_value_vector(const vector<double>& value_vector)
+{
+    size_t index = 0;
+    set_subtree_values(root_, value_vector, index);
+    reset_current_node();
+}
+
+//Recursively push the values of the subtree associated to the node
+void BinaryTree::get_subtree_values(BinaryTreeNode* node,
+    vector<double>& value_vector) const
+{
+    if (node != nullptr)
+    {
+        value_vector.push_back(node->value);
+        get_subtree_values(node->child_left, value_vector);
+        get_subtree_values(node->child_right, value_vector);
+    }
+}
+
+//Recursively set the values of the subtree associated to the node
+void BinaryTree::set_subtree_values(BinaryTreeNode* node,
+    const vector<double>& value_vector, size_t& index)
+{
+    if (node != nullptr)
+    {
+        node->value = value_vector.at(index);
+        index += 1;
+        set_subtree_values(node->child_left, value_vector, index);
+        set_subtree_values(node->child_right, value_vector, index);
+    }
+}
+
 //remove value for all nodes
 void BinaryTree::clear()
 {
@@ -54,9 +54,11 @@ public:
     BinaryTree();
     BinaryTree(unsigned int n_leaves);
     BinaryTree(const BinaryTree& tree);
+    BinaryTree(BinaryTree&& tree) noexcept;
 
     //Assignement operator
     BinaryTree& operator=(const BinaryTree& tree);
+    BinaryTree& operator=(BinaryTree&& tree) noexcept;
 
     //Destructor
     ~BinaryTree();
@@ -76,6 +78,9 @@ public:
     LeafIndex get_leaf_index() const
         {return leaves_index_map_.at(current_node_);}
     LeafIndex get_leaf_index(double r);
+    std::size_t get_number_of_leaves() const
+        {return leaves_vector_.size();}
+    std::vector<double> get_value_vector() const;
 
     //Mutators
     void reset_current_node()
@@ -92,6 +97,7 @@ public:
     void update_value(double variation);
     void update_zero();
     void clear();
+    void set_value_vector(const std::vector<double>& value_vector);
 
 
 private:
@@ -108,6 +114,12 @@ private:
     //to be called by destructor
     void destroy_tree(BinaryTreeNode* node);
 
+    //to be called by get_value_vector and set_value_vector
+    void get_subtree_values(BinaryTreeNode* node,
+        std::vector<double>& value_vector) const;
+    void set_subtree_values(BinaryTreeNode* node,
+        const std::vector<double>& value_vector, std::size_t& index);
+
 };
 
 
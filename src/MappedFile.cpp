@@ -0,0 +1,91 @@
+/**
+* \file MappedFile.cpp
+* \brief Methods for the class MappedFile
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#include <MappedFile.hpp>
+#include <stdexcept>
+#include <fstream>
+#if defined(_WIN32)
+#define SPREADING_CR_NO_MMAP
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace net
+{//start of namespace net
+
+/*---------------------------
+ *      Constructor
+ *---------------------------*/
+
+/**
+* \brief Constructor of the class
+* \param[in] path path name to the file
+*/
+MappedFile::MappedFile(const string& path) :
+    data_(nullptr), size_(0), buffer_()
+{
+#ifdef SPREADING_CR_NO_MMAP
+    ifstream in(path, ios::in | ios::binary | ios::ate);
+    if (not in)
+    {
+        throw runtime_error("Cannot open file " + path);
+    }
+    buffer_.resize(in.tellg());
+    in.seekg(0);
+    in.read(buffer_.data(), buffer_.size());
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#else
+    int file_descriptor = open(path.c_str(), O_RDONLY);
+    if (file_descriptor < 0)
+    {
+        throw runtime_error("Cannot open file " + path);
+    }
+    struct stat file_status;
+    if (fstat(file_descriptor, &file_status) != 0)
+    {
+        close(file_descriptor);
+        throw runtime_error("Cannot read the size of file " + path);
+    }
+    size_ = file_status.st_size;
+    if (size_ > 0)
+    {
+        void* address = mmap(nullptr, size_, PROT_READ, MAP_SHARED,
+            file_descriptor, 0);
+        if (address == MAP_FAILED)
+        {
+            close(file_descriptor);
+            throw runtime_error("Cannot map file " + path);
+        }
+        data_ = static_cast<const char*>(address);
+    }
+    //the mapping stays valid after the file is closed
+    close(file_descriptor);
+#endif
+}
+
+/*---------------------------
+ *      Destructor
+ *---------------------------*/
+
+MappedFile::~MappedFile()
+{
+#ifndef SPREADING_CR_NO_MMAP
+    if (data_ != nullptr)
+    {
+        munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
+
+}//end of namespace net
@@ -0,0 +1,51 @@
+/**
+* \file MappedFile.hpp
+* \brief Header file for class MappedFile
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#ifndef MAPPEDFILE_HPP_
+#define MAPPEDFILE_HPP_
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace net
+{//start of namespace net
+
+/**
+* \class MappedFile MappedFile.hpp
+* \brief Read-only view on the content of a file, mapped in memory.
+*
+* The pages are shared with the other processes mapping the same file. On
+* systems without mmap, the file is read in memory instead.
+*/
+class MappedFile
+{
+public:
+    //Constructor
+    MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    //Destructor
+    ~MappedFile();
+
+    //Accessors
+    const char* data() const
+        {return data_;}
+    std::size_t size() const
+        {return size_;}
+
+private:
+    const char* data_;
+    std::size_t size_;
+    std::vector<char> buffer_; //content when the file is not mapped
+};
+
+}//end of namespace net
+
+#endif /* MAPPEDFILE_HPP_ */
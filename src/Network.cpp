@@ -3,31 +3,41 @@
 * \brief Methods for the class Network
 * \author Guillaume St-Onge
 * \version 1.0
-* \date 
+* \date
 */
 
 #include "Network.hpp"
+#include <parallel.hpp>
+#include <stdexcept>
+#include <algorithm>
 
 using namespace std;
 
 namespace net
 {//start of namespace net
 
+//Define structure owning the arrays of a network built in memory
+struct CSRStorage
+{
+    vector<uint64_t> offset_vector;
+    vector<NodeLabel> neighbor_vector;
+};
 
 /*---------------------------
  *      Constructor
  *---------------------------*/
 
 /**
-* \brief Constructor of the class
+* \brief Constructor of the class. The neighbors of each node are in the
+*  order of the edge list.
 * \param[in] edge_list a vector of node index pair representing the edge list
 */
 Network::Network(vector<pair<NodeLabel, NodeLabel> >& edge_list) :
-	adjacency_list_(new vector<vector<NodeLabel> >)
+	storage_(), offset_(nullptr), neighbor_(nullptr), size_(0)
 {
 	size_t N = 0;
 	//Determine the number of nodes (brut force)
-	for (int i = 0; i<edge_list.size(); i++)
+	for (size_t i = 0; i < edge_list.size(); i++)
     {
     	if (edge_list[i].first > N)
     	{
@@ -39,31 +49,159 @@ Network::Network(vector<pair<NodeLabel, NodeLabel> >& edge_list) :
     	}
     }
     N += 1; //the label starts to 0 by convention
-    //Initialize adjacency_list_
-    vector<NodeLabel> node_vector;
-    for (NodeLabel i = 0; i < N; i++)
+
+    //count the neighbors of each node, then place them
+    vector<uint64_t> offset_vector(N+1, 0);
+    for (size_t i = 0; i < edge_list.size(); i++)
+    {
+        offset_vector[edge_list[i].first+1] += 1;
+        offset_vector[edge_list[i].second+1] += 1;
+    }
+    for (size_t node = 0; node < N; node++)
     {
-    	adjacency_list_->push_back(node_vector);
+        offset_vector[node+1] += offset_vector[node];
     }
-    for (int i = 0; i < edge_list.size(); i++)
+    vector<NodeLabel> neighbor_vector(offset_vector[N]);
+    vector<uint64_t> position_vector(offset_vector.begin(),
+        offset_vector.end() - 1);
+    for (size_t i = 0; i < edge_list.size(); i++)
     {
     	NodeLabel n1 = edge_list[i].first;
     	NodeLabel n2 = edge_list[i].second;
-    	(*adjacency_list_)[n1].push_back(n2);
-    	(*adjacency_list_)[n2].push_back(n1);
+        neighbor_vector[position_vector[n1]++] = n2;
+        neighbor_vector[position_vector[n2]++] = n1;
     }
+    set_storage(move(offset_vector), move(neighbor_vector));
 }
 
 /**
-* \brief Constructor of the class. The adjacency list is an alias to an
-*  external adjacency list.
-* \param[in] adjacency_list a vector containing the vector of neighbors for 
-*  each node
+* \brief Constructor of the class from the compressed sparse row arrays. The
+*  adjacency must be symmetric.
+* \param[in] offset_vector position of the first neighbor of each node,
+*  followed by the total number of neighbors
+* \param[in] neighbor_vector concatenated neighbors of the nodes
+*/
+Network::Network(vector<uint64_t>&& offset_vector,
+    vector<NodeLabel>&& neighbor_vector) :
+	storage_(), offset_(nullptr), neighbor_(nullptr), size_(0)
+{
+    if (offset_vector.empty())
+    {
+        offset_vector.push_back(0);
+    }
+    size_t N = offset_vector.size() - 1;
+    if (offset_vector[0] != 0 or offset_vector[N] != neighbor_vector.size())
+    {
+        throw invalid_argument("Offsets do not match the neighbors");
+    }
+    for (size_t node = 0; node < N; node++)
+    {
+        if (offset_vector[node+1] < offset_vector[node])
+        {
+            throw invalid_argument("Offsets must be nondecreasing");
+        }
+    }
+    for (NodeLabel neighbor : neighbor_vector)
+    {
+        if (neighbor >= N)
+        {
+            throw invalid_argument("Neighbor label out of range");
+        }
+    }
+    set_storage(move(offset_vector), move(neighbor_vector));
+}
+
+/**
+* \brief Edges of the blocks of an edge list, for the constructor from groups
+*  of edges
+*/
+struct EdgeBlockGroup
+{
+    const vector<vector<pair<NodeLabel, NodeLabel> > >& edge_list_vector;
+
+    template <class Function>
+    void operator()(size_t block, Function function) const
+    {
+        for (const auto& edge : edge_list_vector[block])
+        {
+            function(edge.first, edge.second);
+        }
+    }
+};
+
+/**
+* \brief Constructor of the class from an edge list split in blocks, built on
+*  multiple threads. Each block is a group of edges (see the constructor from
+*  groups of edges), so the extra memory is one counter per node, whatever
+*  the number of blocks. The neighbors of each node are sorted.
+* \param[in] edge_list_vector blocks of the edge list
+* \param[in] size number of nodes, larger than every label
+* \param[in] thread_number number of threads (0: hardware concurrency)
+*/
+Network::Network(
+    const vector<vector<pair<NodeLabel, NodeLabel> > >& edge_list_vector,
+    size_t size, unsigned int thread_number) :
+	storage_(), offset_(nullptr), neighbor_(nullptr), size_(0)
+{
+    if (size == 0)
+    {
+        //no node; the constructor from groups would deduce the size
+        for (const auto& edge_list : edge_list_vector)
+        {
+            if (not edge_list.empty())
+            {
+                throw invalid_argument("Node label out of range");
+            }
+        }
+        set_storage(vector<uint64_t>(1, 0), vector<NodeLabel>());
+        return;
+    }
+    *this = Network(edge_list_vector.size(),
+        EdgeBlockGroup{edge_list_vector}, size, thread_number);
+}
+
+/**
+* \brief Constructor of the class from compressed sparse row arrays owned by
+*  another object, for instance a memory-mapped file. The arrays are not
+*  copied nor checked, apart from their first and last offsets.
+* \param[in] storage owner of the arrays, kept alive by the network
+* \param[in] offset position of the first neighbor of each node, followed by
+*  the total number of neighbors (size + 1 entries)
+* \param[in] neighbor concatenated neighbors of the nodes
+* \param[in] size number of nodes
+*/
+Network::Network(shared_ptr<const void> storage, const uint64_t* offset,
+    const NodeLabel* neighbor, size_t size) :
+	storage_(move(storage)), offset_(offset), neighbor_(neighbor), size_(size)
+{
+    if (offset_ == nullptr or offset_[0] != 0
+        or (offset_[size_] > 0 and neighbor_ == nullptr))
+    {
+        throw invalid_argument("Invalid compressed sparse row arrays");
+    }
+}
+
+/*---------------------------
+ *      Mutators
+ *---------------------------*/
+
+/**
+* \brief Take ownership of the arrays of the network
+* \param[in] offset_vector position of the first neighbor of each node,
+*  followed by the total number of neighbors
+* \param[in] neighbor_vector concatenated neighbors of the nodes
 */
-Network::Network(vector<vector<NodeLabel> >* adjacency_list) :
-    adjacency_list_(adjacency_list)
+void Network::set_storage(vector<uint64_t>&& offset_vector,
+    vector<NodeLabel>&& neighbor_vector)
 {
+    shared_ptr<CSRStorage> storage = make_shared<CSRStorage>();
+    storage->offset_vector = move(offset_vector);
+    storage->neighbor_vector = move(neighbor_vector);
+    offset_ = storage->offset_vector.data();
+    neighbor_ = storage->neighbor_vector.data();
+    size_ = storage->offset_vector.size() - 1;
+    storage_ = storage;
 }
 
 
-}//end of namespace net
\ No newline at end of file
+}//end of namespace net
@@ -9,20 +9,65 @@
 #ifndef NETWORK_HPP_
 #define NETWORK_HPP_
 
+#include <parallel.hpp>
 #include <utility>
 #include <vector>
 #include <memory>
+#include <stdexcept>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
 
 namespace net
 {//start of namespace net
 
-typedef unsigned int NodeLabel;
+//Label of the nodes, on 32 bits unless the library is built with
+//SPREADING_CR_LABEL64 for networks of 2^32 nodes or more. The numbers of
+//nodes recorded at each event have the same width.
+#ifdef SPREADING_CR_LABEL64
+typedef uint64_t NodeLabel;
+#else
+typedef uint32_t NodeLabel;
+#endif
 
+/**
+* \class NeighborRange Network.hpp
+* \brief Read-only view on the neighbors of a node.
+*/
+class NeighborRange
+{
+public:
+    //Constructor
+    NeighborRange(const NodeLabel* first, const NodeLabel* last) :
+        first_(first), last_(last) {}
+
+    //Accessors
+    std::size_t size() const
+        {return last_ - first_;}
+    bool empty() const
+        {return first_ == last_;}
+    const NodeLabel& operator[](std::size_t index) const
+        {return first_[index];}
+    const NodeLabel* begin() const
+        {return first_;}
+    const NodeLabel* end() const
+        {return last_;}
+
+private:
+    const NodeLabel* first_;
+    const NodeLabel* last_;
+};
 
 /**
 * \class Network Network.hpp
-* \brief Framework for the establishement of propagation dynamics on an 
+* \brief Framework for the establishement of propagation dynamics on an
 *  undirected networks.
+*
+* The adjacency is stored in compressed sparse row form: the neighbors of
+* node i are neighbor[offset[i]], ..., neighbor[offset[i+1]-1]. The arrays
+* are immutable and shared by all the copies of a network; they are either
+* owned by the network or by an external storage, such as a mapped file.
 */
 
 class Network
@@ -30,23 +75,167 @@ class Network
 public:
     //Constructor
     Network(std::vector<std::pair<NodeLabel, NodeLabel> >& edge_list);
-    Network(std::vector<std::vector<NodeLabel> >* adjacency_list);
+    Network(std::vector<uint64_t>&& offset_vector,
+        std::vector<NodeLabel>&& neighbor_vector);
+    Network(const std::vector<std::vector<std::pair<NodeLabel, NodeLabel> > >&
+        edge_list_vector, std::size_t size, unsigned int thread_number = 1);
+    Network(std::shared_ptr<const void> storage, const uint64_t* offset,
+        const NodeLabel* neighbor, std::size_t size);
+    template <class EdgeGroup>
+    Network(std::size_t group_number, EdgeGroup edge_group, std::size_t size,
+        unsigned int thread_number);
 
     //Accessors
-    std::size_t degree(NodeLabel node) const 
-    	{return (*adjacency_list_)[node].size();}
-    std::size_t size() const 
-        {return adjacency_list_->size();}
-    const std::vector<NodeLabel>& get_neighbor_vector(NodeLabel node) const
-    	{return (*adjacency_list_)[node];}
-    const std::vector<std::vector<NodeLabel> >& get_adjacency_list() const 
-        {return *adjacency_list_;}
+    std::size_t degree(NodeLabel node) const
+    	{return offset_[node+1] - offset_[node];}
+    std::size_t size() const
+        {return size_;}
+    NeighborRange get_neighbor_vector(NodeLabel node) const
+    	{return NeighborRange(neighbor_ + offset_[node],
+            neighbor_ + offset_[node+1]);}
+    const uint64_t* get_offset_data() const
+        {return offset_;}
+    const NodeLabel* get_neighbor_data() const
+        {return neighbor_;}
+    std::size_t get_neighbor_number() const
+        {return offset_[size_];}
 
 private:
     //Members
-    std::shared_ptr<std::vector<std::vector<NodeLabel> > > adjacency_list_;
+    std::shared_ptr<const void> storage_; //owner of the arrays
+    const uint64_t* offset_; //size_ + 1 entries
+    const NodeLabel* neighbor_;
+    std::size_t size_;
+
+    //private methods
+    void set_storage(std::vector<uint64_t>&& offset_vector,
+        std::vector<NodeLabel>&& neighbor_vector);
 };
 
+/**
+* \brief Constructor of the class from an edge list split in groups, built on
+*  multiple threads without a copy of the edges. The neighbors of the nodes
+*  are counted with shared atomic counters, which become the cursors of the
+*  nodes after a prefix sum; each group then writes its neighbors at the
+*  cursors of the nodes. Every thread reads only its groups, and the only
+*  extra memory is one counter per node. The order in which the groups write
+*  depends on the threads, hence the neighbors of each node are sorted.
+* \param[in] group_number number of groups of edges
+* \param[in] edge_group callable such that edge_group(g, f) calls f(n1, n2)
+*  for each edge (n1, n2) of group g
+* \param[in] size number of nodes, larger than every label (0: largest label
+*  plus one, found by reading the edges once more)
+* \param[in] thread_number number of threads (0: hardware concurrency)
+*/
+template <class EdgeGroup>
+Network::Network(std::size_t group_number, EdgeGroup edge_group,
+    std::size_t size, unsigned int thread_number) :
+	storage_(), offset_(nullptr), neighbor_(nullptr), size_(0)
+{
+    std::size_t N = size;
+    if (N == 0)
+    {
+        std::vector<std::size_t> max_vector(group_number, 0);
+        parallel_for(group_number, thread_number, [&](std::size_t group)
+        {
+            edge_group(group, [&](NodeLabel node1, NodeLabel node2)
+            {
+                max_vector[group] = std::max(max_vector[group],
+                    std::size_t(std::max(node1, node2)));
+            });
+        });
+        N = 1;
+        for (std::size_t max_label : max_vector)
+        {
+            N = std::max(N, max_label + 1);
+        }
+    }
+
+    //number of neighbors of each node; the counters are only incremented
+    //with atomic operations when several threads share them
+    std::vector<std::atomic<uint64_t> > cursor_vector(N);
+    bool concurrent = (std::min(std::size_t(thread_number == 0 ?
+        std::thread::hardware_concurrency() : thread_number), group_number)
+        > 1);
+    auto increment = [&](NodeLabel node) -> uint64_t
+    {
+        if (concurrent)
+        {
+            return cursor_vector[node].fetch_add(1,
+                std::memory_order_relaxed);
+        }
+        uint64_t value = cursor_vector[node].load(std::memory_order_relaxed);
+        cursor_vector[node].store(value + 1, std::memory_order_relaxed);
+        return value;
+    };
+    parallel_for(group_number, thread_number, [&](std::size_t group)
+    {
+        edge_group(group, [&](NodeLabel node1, NodeLabel node2)
+        {
+            if (node1 >= N or node2 >= N)
+            {
+                throw std::invalid_argument("Node label out of range");
+            }
+            increment(node1);
+            increment(node2);
+        });
+    });
+    std::vector<uint64_t> offset_vector(N+1, 0);
+    for (std::size_t node = 0; node < N; node++)
+    {
+        offset_vector[node+1] = offset_vector[node] + cursor_vector[node];
+        cursor_vector[node] = offset_vector[node];
+    }
+
+    //the neighbors are placed by batches: an atomic operation waits for the
+    //pending stores, so taking the positions of a whole batch first lets
+    //the scattered stores proceed together
+    std::vector<NodeLabel> neighbor_vector(offset_vector[N]);
+    const std::size_t BATCH_SIZE = 1024;
+    parallel_for(group_number, thread_number, [&](std::size_t group)
+    {
+        std::vector<std::pair<NodeLabel, NodeLabel> > batch;
+        std::vector<uint64_t> position_vector(BATCH_SIZE);
+        batch.reserve(BATCH_SIZE);
+        auto place = [&]()
+        {
+            for (std::size_t i = 0; i < batch.size(); i++)
+            {
+                position_vector[i] = increment(batch[i].first);
+            }
+            for (std::size_t i = 0; i < batch.size(); i++)
+            {
+                neighbor_vector[position_vector[i]] = batch[i].second;
+            }
+            batch.clear();
+        };
+        edge_group(group, [&](NodeLabel node1, NodeLabel node2)
+        {
+            batch.emplace_back(node1, node2);
+            batch.emplace_back(node2, node1);
+            if (batch.size() >= BATCH_SIZE)
+            {
+                place();
+            }
+        });
+        place();
+    });
+    std::vector<std::atomic<uint64_t> >().swap(cursor_vector);
+
+    std::size_t block_number = std::min(std::size_t(16)*
+        std::max(thread_number, 1u), N);
+    parallel_for(block_number, thread_number, [&](std::size_t block)
+    {
+        for (std::size_t node = N*block/block_number;
+            node < N*(block+1)/block_number; node++)
+        {
+            std::sort(neighbor_vector.begin() + offset_vector[node],
+                neighbor_vector.begin() + offset_vector[node+1]);
+        }
+    });
+    set_storage(std::move(offset_vector), std::move(neighbor_vector));
+}
+
 }//end of namespace net
 
-#endif /* NETWORK_HPP_ */
\ No newline at end of file
+#endif /* NETWORK_HPP_ */
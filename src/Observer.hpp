@@ -0,0 +1,484 @@
+/**
+* \file Observer.hpp
+* \brief Header file for the observers of the spreading processes
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#ifndef OBSERVER_HPP_
+#define OBSERVER_HPP_
+
+#include <StaticNetworkSIR.hpp>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <cmath>
+
+namespace net
+{//start of namespace net
+
+//Define the type of event changing the state of the system
+enum EventType
+{
+    NULL_EVENT, //unsuccessful infection attempt
+    INFECTION_EVENT,
+    RECOVERY_EVENT,
+    IMMUNITY_LOSS_EVENT
+};
+
+//Define the structure describing an event
+struct Event
+{
+    Event() : type(NULL_EVENT), node(0), source(0) {}
+    EventType type;
+    NodeLabel node; //node changing state
+    NodeLabel source; //infecting node, for infection events only
+};
+
+/*
+ * An observer is any object implementing the three following methods:
+ *
+ *   void begin(double time, const StaticNetworkSIR& net);
+ *   void operator()(const Event& event, double time,
+ *       const StaticNetworkSIR& net);
+ *   void end(double time, const StaticNetworkSIR& net);
+ *
+ * begin and end are called at the start and the end of each call to evolve,
+ * operator() after each event changing the state of the system. Observers
+ * are template parameters of the process, so that unused hooks vanish.
+ */
+
+/**
+* \class NullObserver Observer.hpp
+* \brief Observer doing nothing.
+*/
+class NullObserver
+{
+public:
+    void begin(double time, const StaticNetworkSIR& net) {}
+    void operator()(const Event& event, double time,
+        const StaticNetworkSIR& net) {}
+    void end(double time, const StaticNetworkSIR& net) {}
+};
+
+/**
+* \class ObserverPair Observer.hpp
+* \brief Observer forwarding the calls to two other observers.
+*/
+template <class FirstObserver, class SecondObserver>
+class ObserverPair
+{
+public:
+    ObserverPair(FirstObserver& first, SecondObserver& second) :
+        first_(first), second_(second) {}
+
+    void begin(double time, const StaticNetworkSIR& net)
+        {first_.begin(time, net); second_.begin(time, net);}
+    void operator()(const Event& event, double time,
+        const StaticNetworkSIR& net)
+        {first_(event, time, net); second_(event, time, net);}
+    void end(double time, const StaticNetworkSIR& net)
+        {first_.end(time, net); second_.end(time, net);}
+
+private:
+    FirstObserver& first_;
+    SecondObserver& second_;
+};
+
+/**
+* \class MeanPrevalenceObserver Observer.hpp
+* \brief Time-weighted average of the prevalence.
+*/
+class MeanPrevalenceObserver
+{
+public:
+    MeanPrevalenceObserver() :
+        last_time_(0.), last_Inode_number_(0), duration_(0.),
+        weighted_Inode_number_(0.), size_(1) {}
+
+    //Accessors
+    double get_mean_prevalence() const
+        {return (duration_ > 0) ?
+            weighted_Inode_number_/(duration_*size_) : 0.;}
+    double get_duration() const
+        {return duration_;}
+
+    //Mutators
+    void reset()
+        {duration_ = 0.; weighted_Inode_number_ = 0.;}
+    void begin(double time, const StaticNetworkSIR& net)
+    {
+        last_time_ = time;
+        last_Inode_number_ = net.get_Inode_number();
+        size_ = net.size();
+    }
+    void operator()(const Event& event, double time,
+        const StaticNetworkSIR& net)
+    {
+        accumulate(time);
+        last_Inode_number_ = net.get_Inode_number();
+    }
+    void end(double time, const StaticNetworkSIR& net)
+        {accumulate(time);}
+
+private:
+    double last_time_;
+    std::size_t last_Inode_number_;
+    double duration_;
+    double weighted_Inode_number_;
+    std::size_t size_;
+
+    void accumulate(double time)
+    {
+        duration_ += time - last_time_;
+        weighted_Inode_number_ += (time - last_time_)*last_Inode_number_;
+        last_time_ = time;
+    }
+};
+
+/**
+* \class PeakPrevalenceObserver Observer.hpp
+* \brief Maximal prevalence reached and the time at which it is reached.
+*/
+class PeakPrevalenceObserver
+{
+public:
+    PeakPrevalenceObserver() :
+        peak_Inode_number_(0), peak_time_(0.), size_(1) {}
+
+    //Accessors
+    double get_peak_prevalence() const
+        {return (1.*peak_Inode_number_)/size_;}
+    std::size_t get_peak_Inode_number() const
+        {return peak_Inode_number_;}
+    double get_peak_time() const
+        {return peak_time_;}
+
+    //Mutators
+    void reset()
+        {peak_Inode_number_ = 0; peak_time_ = 0.;}
+    void begin(double time, const StaticNetworkSIR& net)
+    {
+        size_ = net.size();
+        update(time, net);
+    }
+    void operator()(const Event& event, double time,
+        const StaticNetworkSIR& net)
+        {update(time, net);}
+    void end(double time, const StaticNetworkSIR& net) {}
+
+private:
+    std::size_t peak_Inode_number_;
+    double peak_time_;
+    std::size_t size_;
+
+    void update(double time, const StaticNetworkSIR& net)
+    {
+        if (net.get_Inode_number() > peak_Inode_number_)
+        {
+            peak_Inode_number_ = net.get_Inode_number();
+            peak_time_ = time;
+        }
+    }
+};
+
+/**
+* \class InfectedHistogramObserver Observer.hpp
+* \brief Time spent with each number of infected nodes.
+*/
+class InfectedHistogramObserver
+{
+public:
+    InfectedHistogramObserver() :
+        last_time_(0.), last_Inode_number_(0), histogram_() {}
+
+    //Accessors
+    const std::vector<double>& get_histogram() const
+        {return histogram_;}
+
+    //Mutators
+    void reset()
+        {std::fill(histogram_.begin(), histogram_.end(), 0.);}
+    void begin(double time, const StaticNetworkSIR& net)
+    {
+        if (histogram_.size() != net.size()+1)
+        {
+            histogram_.assign(net.size()+1, 0.);
+        }
+        last_time_ = time;
+        last_Inode_number_ = net.get_Inode_number();
+    }
+    void operator()(const Event& event, double time,
+        const StaticNetworkSIR& net)
+    {
+        accumulate(time);
+        last_Inode_number_ = net.get_Inode_number();
+    }
+    void end(double time, const StaticNetworkSIR& net)
+        {accumulate(time);}
+
+private:
+    double last_time_;
+    std::size_t last_Inode_number_;
+    std::vector<double> histogram_;
+
+    void accumulate(double time)
+    {
+        histogram_[last_Inode_number_] += time - last_time_;
+        last_time_ = time;
+    }
+};
+
+/**
+* \class SecondaryCaseObserver Observer.hpp
+* \brief Number of infections caused by a tracked node.
+*/
+class SecondaryCaseObserver
+{
+public:
+    SecondaryCaseObserver(NodeLabel node = 0) :
+        node_(node), secondary_case_number_(0), last_secondary_node_(0) {}
+
+    //Accessors
+    NodeLabel get_node() const
+        {return node_;}
+    std::size_t get_secondary_case_number() const
+        {return secondary_case_number_;}
+    NodeLabel get_last_secondary_node() const
+        {return last_secondary_node_;}
+
+    //Mutators
+    void reset(NodeLabel node)
+        {node_ = node; secondary_case_number_ = 0;}
+    void begin(double time, const StaticNetworkSIR& net) {}
+    void operator()(const Event& event, double time,
+        const StaticNetworkSIR& net)
+    {
+        if (event.type == INFECTION_EVENT and event.source == node_)
+        {
+            secondary_case_number_ += 1;
+            last_secondary_node_ = event.node;
+        }
+    }
+    void end(double time, const StaticNetworkSIR& net) {}
+
+private:
+    NodeLabel node_;
+    std::size_t secondary_case_number_;
+    NodeLabel last_secondary_node_;
+};
+
+/**
+* \class ReproductionNumberObserver Observer.hpp
+* \brief Effective reproduction number R_t, binned by infection time.
+*
+* When a node recovers, its number of secondary cases is complete and is
+* attributed to the bin of its infection time. The nodes infected when the
+* observer first begins are taken as infected at that time; the nodes still
+* infected are not counted.
+*/
+class ReproductionNumberObserver
+{
+public:
+    ReproductionNumberObserver(double bin_width = 1.) :
+        bin_width_(bin_width), started_(false), infection_time_vector_(),
+        secondary_case_vector_(), case_number_vector_(),
+        secondary_case_number_vector_()
+    {
+        if (not (bin_width > 0) or std::isinf(bin_width))
+        {
+            throw std::invalid_argument(
+                "The bin width must be positive and finite");
+        }
+    }
+
+    //Accessors
+    double get_bin_width() const
+        {return bin_width_;}
+    const std::vector<std::size_t>& get_case_number_vector() const
+        {return case_number_vector_;}
+    const std::vector<std::size_t>& get_secondary_case_number_vector() const
+        {return secondary_case_number_vector_;}
+    std::vector<double> get_reproduction_number_vector() const
+    {
+        std::vector<double> reproduction_number_vector(
+            case_number_vector_.size(),
+            std::numeric_limits<double>::quiet_NaN());
+        for (std::size_t bin = 0; bin < case_number_vector_.size(); bin++)
+        {
+            if (case_number_vector_[bin] > 0)
+            {
+                reproduction_number_vector[bin] =
+                    (1.*secondary_case_number_vector_[bin])
+                    /case_number_vector_[bin];
+            }
+        }
+        return reproduction_number_vector;
+    }
+
+    //Mutators
+    void reset()
+    {
+        started_ = false;
+        std::fill(infection_time_vector_.begin(),
+            infection_time_vector_.end(),
+            std::numeric_limits<double>::quiet_NaN());
+        std::fill(secondary_case_vector_.begin(),
+            secondary_case_vector_.end(), 0);
+        case_number_vector_.clear();
+        secondary_case_number_vector_.clear();
+    }
+    void begin(double time, const StaticNetworkSIR& net)
+    {
+        if (not started_)
+        {
+            started_ = true;
+            infection_time_vector_.assign(net.size(),
+                std::numeric_limits<double>::quiet_NaN());
+            secondary_case_vector_.assign(net.size(), 0);
+            for (NodeLabel node : net.get_Inode_vector())
+            {
+                infection_time_vector_[node] = time;
+            }
+        }
+    }
+    void operator()(const Event& event, double time,
+        const StaticNetworkSIR& net)
+    {
+        if (event.type == INFECTION_EVENT)
+        {
+            infection_time_vector_[event.node] = time;
+            secondary_case_vector_[event.node] = 0;
+            secondary_case_vector_[event.source] += 1;
+        }
+        else if (event.type == RECOVERY_EVENT)
+        {
+            double infection_time = infection_time_vector_[event.node];
+            if (not std::isnan(infection_time))
+            {
+                std::size_t bin = std::floor(infection_time/bin_width_);
+                if (bin >= case_number_vector_.size())
+                {
+                    case_number_vector_.resize(bin+1, 0);
+                    secondary_case_number_vector_.resize(bin+1, 0);
+                }
+                case_number_vector_[bin] += 1;
+                secondary_case_number_vector_[bin] +=
+                    secondary_case_vector_[event.node];
+                infection_time_vector_[event.node] =
+                    std::numeric_limits<double>::quiet_NaN();
+            }
+        }
+    }
+    void end(double time, const StaticNetworkSIR& net) {}
+
+private:
+    double bin_width_;
+    bool started_;
+    std::vector<double> infection_time_vector_; //NaN if not infected
+    std::vector<unsigned int> secondary_case_vector_;
+    std::vector<std::size_t> case_number_vector_;
+    std::vector<std::size_t> secondary_case_number_vector_;
+};
+
+//Infector of the nodes infected initially or not infected
+constexpr const NodeLabel NO_INFECTOR = std::numeric_limits<NodeLabel>::max();
+
+/**
+* \class InfectionRecorder Observer.hpp
+* \brief Time, infector and generation of the first infection of each node.
+*
+* Nodes never infected have a NaN infection time. Seeds (nodes infected
+* without an infection event, see record_seeds) have generation 0 and
+* NO_INFECTOR as infector. The vectors are allocated once by enable and
+* never reallocated afterwards.
+*/
+class InfectionRecorder
+{
+public:
+    InfectionRecorder() :
+        enabled_(false), infection_time_vector_(), infector_vector_(),
+        generation_vector_(), infected_node_vector_() {}
+
+    //Accessors
+    bool is_enabled() const
+        {return enabled_;}
+    const std::vector<double>& get_infection_time_vector() const
+        {return infection_time_vector_;}
+    const std::vector<NodeLabel>& get_infector_vector() const
+        {return infector_vector_;}
+    const std::vector<unsigned int>& get_generation_vector() const
+        {return generation_vector_;}
+    const std::vector<NodeLabel>& get_infected_node_vector() const
+        {return infected_node_vector_;}
+
+    //Mutators
+    void enable(std::size_t size)
+    {
+        enabled_ = true;
+        infection_time_vector_.assign(size,
+            std::numeric_limits<double>::quiet_NaN());
+        infector_vector_.assign(size, NO_INFECTOR);
+        generation_vector_.assign(size, 0);
+        infected_node_vector_.clear();
+        infected_node_vector_.reserve(size);
+    }
+    void disable()
+        {enabled_ = false;} //the record is kept as is
+    void reset()
+    {
+        //only the infected nodes have to be cleared
+        for (NodeLabel node : infected_node_vector_)
+        {
+            infection_time_vector_[node] =
+                std::numeric_limits<double>::quiet_NaN();
+            infector_vector_[node] = NO_INFECTOR;
+            generation_vector_[node] = 0;
+        }
+        infected_node_vector_.clear();
+    }
+    void record_seeds(double time, const StaticNetworkSIR& net)
+    {
+        for (NodeLabel node : net.get_Inode_vector())
+        {
+            if (std::isnan(infection_time_vector_[node]))
+            {
+                record(node, time, NO_INFECTOR, 0);
+            }
+        }
+    }
+    void begin(double time, const StaticNetworkSIR& net) {}
+    void operator()(const Event& event, double time,
+        const StaticNetworkSIR& net)
+    {
+        if (event.type == INFECTION_EVENT
+                and std::isnan(infection_time_vector_[event.node]))
+        {
+            record(event.node, time, event.source,
+                generation_vector_[event.source] + 1);
+        }
+    }
+    void end(double time, const StaticNetworkSIR& net) {}
+
+private:
+    bool enabled_;
+    std::vector<double> infection_time_vector_;
+    std::vector<NodeLabel> infector_vector_;
+    std::vector<unsigned int> generation_vector_;
+    std::vector<NodeLabel> infected_node_vector_; //in order of infection
+
+    void record(NodeLabel node, double time, NodeLabel infector,
+        unsigned int generation)
+    {
+        infection_time_vector_[node] = time;
+        infector_vector_[node] = infector;
+        generation_vector_[node] = generation;
+        infected_node_vector_.push_back(node);
+    }
+};
+
+}//end of namespace net
+
+#endif /* OBSERVER_HPP_ */
@@ -8,17 +8,24 @@
 
 #include <QSSpreadingProcess.hpp>
 #include <evolution.hpp>
+#include <io_data.hpp>
 #include <iostream>
+#include <fstream>
 #include <cmath>
 #include <exception>
 #include <stdexcept>
 #include <utility>
+#include <limits>
+#include <algorithm>
 
 using namespace std;
 
 namespace net
 {//start of namespace net
 
+//minimal number of journal entries of an epoch before a new one is started
+static const size_t MIN_JOURNAL_SIZE = 1024;
+
 struct MyException : public exception {
    const char * what () const throw () {
       return "Transmission rate must be greater than 0";
@@ -26,6 +33,53 @@ struct MyException : public exception {
 };
 
 
+/**
+ * \brief Quasi-stationary estimates from the time spent with each number of
+ *  infected nodes
+ * \param[in] occupation_time_vector time spent with n infected nodes
+ * \param[in] absorption_number number of absorptions during that time
+ * \param[in] size number of nodes
+ */
+QSEstimate qs_estimate(const vector<double>& occupation_time_vector,
+        size_t absorption_number, size_t size)
+{
+    QSEstimate estimate;
+    estimate.observation_time = 0;
+    for (double occupation_time : occupation_time_vector)
+    {
+        estimate.observation_time += occupation_time;
+    }
+    estimate.absorption_number = absorption_number;
+    estimate.lifespan = (absorption_number > 0) ?
+        estimate.observation_time/absorption_number :
+        numeric_limits<double>::infinity();
+    if (estimate.observation_time == 0)
+    {
+        estimate.mean_prevalence = numeric_limits<double>::quiet_NaN();
+        estimate.susceptibility = numeric_limits<double>::quiet_NaN();
+        return estimate;
+    }
+
+    //moments of the prevalence
+    double first_moment = 0;
+    double second_moment = 0;
+    estimate.distribution.reserve(occupation_time_vector.size());
+    for (size_t n = 0; n < occupation_time_vector.size(); n++)
+    {
+        double probability = occupation_time_vector[n]
+            /estimate.observation_time;
+        estimate.distribution.push_back(probability);
+        first_moment += probability*n/size;
+        second_moment += probability*n*n/(1.*size*size);
+    }
+    estimate.mean_prevalence = first_moment;
+    //susceptibility of the QS method, whose peak locates the threshold
+    estimate.susceptibility = (first_moment > 0) ?
+        size*(second_moment - first_moment*first_moment)/first_moment :
+        numeric_limits<double>::quiet_NaN();
+    return estimate;
+}
+
 /*---------------------------
  *      Constructor
  *---------------------------*/
@@ -46,13 +100,118 @@ QSSpreadingProcess::QSSpreadingProcess(
     double waning_immunity_rate, double base, double update_history_rate,
     unsigned int history_vector_size) :
     SpreadingProcess(edge_list,transmission_rate,recovery_rate,
-            waning_immunity_rate,base), history_vector_(),
+            waning_immunity_rate,base), history_vector_(), epoch_vector_(),
+    free_epoch_vector_(), current_epoch_(0), replay_state_vector_(),
+    update_history_rate_(update_history_rate),
+    history_vector_size_(history_vector_size),
+    random_index_(0,history_vector_size-1), relaxation_time_(0.),
+    occupation_time_vector_(), absorption_number_(0)
+{
+}
+
+/**
+* \brief Constructor of the class. The network structure is shared.
+* \param[in] network network on which the process takes place
+* \param[in] transmission_rate a double for the rate of transmission
+* \param[in] recovery_rate a double for the rate of recovery
+* \param[in] waning_immunity_rate a double for the rate a node gets immuned
+* \param[in] base a double for the ratio of min max propensity within a group
+* \param[in] update_history_rate a double to push new states in the history
+* \param[in] history_vector_size a double for the maximum size of history
+*/
+QSSpreadingProcess::QSSpreadingProcess(const Network& network,
+    double transmission_rate, double recovery_rate,
+    double waning_immunity_rate, double base, double update_history_rate,
+    unsigned int history_vector_size) :
+    SpreadingProcess(network,transmission_rate,recovery_rate,
+            waning_immunity_rate,base), history_vector_(), epoch_vector_(),
+    free_epoch_vector_(), current_epoch_(0), replay_state_vector_(),
     update_history_rate_(update_history_rate),
     history_vector_size_(history_vector_size),
-    random_index_(0,history_vector_size-1)
+    random_index_(0,history_vector_size-1), relaxation_time_(0.),
+    occupation_time_vector_(), absorption_number_(0)
+{
+}
+
+/**
+* \brief Constructor for a fork of a process. The network structure is shared,
+*  the dynamical state and history are copied and the random number generator
+*  is reseeded on the stream given by the seed.
+* \param[in] process process to fork
+* \param[in] seed seed and stream for the random number generator of the fork
+*/
+QSSpreadingProcess::QSSpreadingProcess(const QSSpreadingProcess& process,
+    unsigned int seed) :
+    SpreadingProcess(process, seed), history_vector_(process.history_vector_),
+    epoch_vector_(process.epoch_vector_),
+    free_epoch_vector_(process.free_epoch_vector_),
+    current_epoch_(process.current_epoch_),
+    replay_state_vector_(process.replay_state_vector_),
+    update_history_rate_(process.update_history_rate_),
+    history_vector_size_(process.history_vector_size_),
+    random_index_(process.random_index_),
+    relaxation_time_(process.relaxation_time_),
+    occupation_time_vector_(process.occupation_time_vector_),
+    absorption_number_(process.absorption_number_)
+{
+}
+
+/*---------------------------
+ *     Accessors
+ *---------------------------*/
+
+/**
+ * \brief Save the complete process (parameters, network, dynamical state
+ *  and history) in binary form
+ * \param[in] out output stream
+ */
+void QSSpreadingProcess::save(ostream& out) const
 {
+    write_checkpoint_header(out, 1);
+    write_binary(out, network_.get_transmission_rate());
+    write_binary(out, network_.get_recovery_rate());
+    write_binary(out, network_.get_waning_immunity_rate());
+    write_binary(out, network_.get_base());
+    write_binary(out, update_history_rate_);
+    write_binary(out, history_vector_size_);
+    write_network(out, network_);
+    save_state(out);
+    //each history state is stored as a snapshot, followed by the epoch of
+    //the current state
+    write_binary(out, static_cast<uint64_t>(history_vector_.size()));
+    vector<unsigned char> replay_state_vector(network_.size(), 0);
+    StateSnapshot snapshot;
+    for (auto& history_state : history_vector_)
+    {
+        replay(history_state, snapshot, replay_state_vector);
+        write_binary_vector(out, snapshot.Inode_vector);
+        write_binary_vector(out, snapshot.Rnode_vector);
+    }
+    if (not history_vector_.empty())
+    {
+        const HistoryEpoch& epoch = epoch_vector_[current_epoch_];
+        write_binary_vector(out, epoch.base.Inode_vector);
+        write_binary_vector(out, epoch.base.Rnode_vector);
+        write_binary_vector(out, epoch.journal);
+    }
+    write_binary(out, relaxation_time_);
+    write_binary_vector(out, occupation_time_vector_);
+    write_binary(out, static_cast<uint64_t>(absorption_number_));
 }
 
+/**
+ * \brief Save the complete process to a binary file
+ * \param[in] path path name to the file
+ */
+void QSSpreadingProcess::save(const string& path) const
+{
+    ofstream out(path, ios::out | ios::binary);
+    if (not out)
+    {
+        throw runtime_error("Cannot open file " + path);
+    }
+    save(out);
+}
 
 /*---------------------------
  *     Mutators
@@ -60,14 +219,67 @@ QSSpreadingProcess::QSSpreadingProcess(
 
 void QSSpreadingProcess::initialize_history_vector()
 {
-    //initialize the history with initial state
-    history_vector_ = vector<Configuration>(history_vector_size_,Configuration());
-    for (int i = 0; i < history_vector_size_ ; i++)
+    //initialize the history with initial state, in a single epoch; the other
+    //epochs keep their memory for later use
+    free_epoch_vector_.clear();
+    if (epoch_vector_.empty())
+    {
+        epoch_vector_.emplace_back();
+    }
+    for (size_t epoch = epoch_vector_.size()-1; epoch > 0; epoch--)
     {
-        network_.get_configuration_copy(history_vector_[i]);
+        epoch_vector_[epoch].journal.clear();
+        epoch_vector_[epoch].reference_number = 0;
+        free_epoch_vector_.push_back(epoch);
     }
+    current_epoch_ = 0;
+    HistoryEpoch& epoch = epoch_vector_[0];
+    network_.get_snapshot(epoch.base);
+    epoch.journal.clear();
+    epoch.reference_number = history_vector_size_;
+    history_vector_.assign(history_vector_size_, HistoryState(0,0));
+}
+
+
+/**
+* \brief Start the clock of the process and the accumulation of the statistics
+*/
+void QSSpreadingProcess::initialize_statistics()
+{
+    current_time_ = 0;
+    reset_statistics();
+}
+
+/**
+* \brief Discard the accumulated quasi-stationary statistics
+*/
+void QSSpreadingProcess::reset_statistics()
+{
+    occupation_time_vector_.clear();
+    absorption_number_ = 0;
 }
 
+/**
+* \brief Add the time spent in the current state to the statistics, for the
+*  part after the relaxation time
+* \param[in] time time at which the current state started
+* \param[in] duration time spent in the current state
+*/
+void QSSpreadingProcess::accumulate_statistics(double time, double duration)
+{
+    double end_time = time + duration;
+    if (end_time <= relaxation_time_)
+    {
+        return;
+    }
+    size_t Inode_number = network_.get_Inode_number();
+    if (Inode_number >= occupation_time_vector_.size())
+    {
+        occupation_time_vector_.resize(Inode_number+1, 0.);
+    }
+    occupation_time_vector_[Inode_number] += end_time
+        - max(time, relaxation_time_);
+}
 
 /**
 * \brief Initialize the state of the system with randomly selected nodes
@@ -78,6 +290,7 @@ void QSSpreadingProcess::initialize_random(double fraction, unsigned int seed)
     gen_.seed(seed);
     infect_fraction(network_, fraction, gen_, random_01_);
     initialize_history_vector();
+    initialize_statistics();
 }
 
 /**
@@ -87,12 +300,10 @@ void QSSpreadingProcess::initialize_random(double fraction, unsigned int seed)
 void QSSpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector,
         unsigned int seed)
 {
-    for (int i=0; i<Inode_vector.size(); i++)
-    {
-    	network_.infection(Inode_vector.at(i));
-    }
+    network_.infection(Inode_vector);
     gen_.seed(seed);
     initialize_history_vector();
+    initialize_statistics();
 }
 
 /**
@@ -101,11 +312,9 @@ void QSSpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector,
 */
 void QSSpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector)
 {
-    for (int i=0; i<Inode_vector.size(); i++)
-    {
-    	network_.infection(Inode_vector.at(i));
-    }
+    network_.infection(Inode_vector);
     initialize_history_vector();
+    initialize_statistics();
 }
 
 
@@ -118,16 +327,14 @@ void QSSpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector)
 void QSSpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector,
         const vector<NodeLabel>& Rnode_vector, unsigned int seed)
 {
-    for (int i=0; i<Inode_vector.size(); i++)
-    {
-    	network_.infection(Inode_vector.at(i));
-    }
-    for (int i=0; i<Rnode_vector.size(); i++)
+    network_.infection(Inode_vector);
+    for (size_t i=0; i<Rnode_vector.size(); i++)
     {
     	network_.set_recovered(Rnode_vector.at(i));
     }
     gen_.seed(seed);
     initialize_history_vector();
+    initialize_statistics();
 }
 
 /**
@@ -139,15 +346,13 @@ void QSSpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector,
 void QSSpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector,
         const vector<NodeLabel>& Rnode_vector)
 {
-    for (int i=0; i<Inode_vector.size(); i++)
-    {
-    	network_.infection(Inode_vector.at(i));
-    }
-    for (int i=0; i<Rnode_vector.size(); i++)
+    network_.infection(Inode_vector);
+    for (size_t i=0; i<Rnode_vector.size(); i++)
     {
     	network_.set_recovered(Rnode_vector.at(i));
     }
     initialize_history_vector();
+    initialize_statistics();
 }
 
 
@@ -157,7 +362,12 @@ void QSSpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector,
 void QSSpreadingProcess::reset()
 {
     network_.reset();
-    history_vector_.clear();
+    initialize_statistics();
+    //the history only holds the empty state, but keeps its memory
+    if (not history_vector_.empty())
+    {
+        initialize_history_vector();
+    }
 }
 
 /**
@@ -166,49 +376,274 @@ void QSSpreadingProcess::reset()
 */
 void QSSpreadingProcess::evolve(double time_variation)
 {
+    if (std::isinf(update_history_rate_))
+    {
+        throw invalid_argument("The update history rate must be finite");
+    }
     double current_time_variation = 0;
     double next_update_time = log_table_[INDEX_MAP(gen_())]/update_history_rate_;
     double dt = get_lifetime(network_, gen_, log_table_);
     while (current_time_variation + dt < time_variation)
     {
+        accumulate_statistics(current_time_ + current_time_variation, dt);
         current_time_variation += dt;
-        if (current_time_variation >= next_update_time)
+        while (current_time_variation >= next_update_time)
         {
             //save current state
             update_history();
             next_update_time += log_table_[INDEX_MAP(gen_())]
                 /update_history_rate_;
         }
-        update_event(network_, gen_, random_01_, transmission_vector_,
-                tracing_);
+        Event event = update_event(network_, gen_, random_01_,
+                transmission_vector_, tracing_);
+        journal_event(event);
         if (is_absorbed())
         {
+            if (current_time_ + current_time_variation >= relaxation_time_)
+            {
+                absorption_number_ += 1;
+            }
             get_configuration_from_history();
         }
         dt = get_lifetime(network_, gen_, log_table_);
     }
+    accumulate_statistics(current_time_ + current_time_variation,
+        time_variation - current_time_variation);
+    current_time_ += time_variation;
 }
 
 /**
-* \brief Update the history with current state
+* \brief Update the history with current state. Only the position in the
+*  journal of the current epoch is stored.
 */
 void QSSpreadingProcess::update_history()
 {
     size_t index = random_index_(gen_);
-    swap(history_vector_[index],history_vector_.back());
-    history_vector_.pop_back();
-    history_vector_.push_back(Configuration());
-    network_.get_configuration_copy(history_vector_.back());
+    release_epoch(history_vector_[index].first);
+    history_vector_[index] = HistoryState(current_epoch_,
+        epoch_vector_[current_epoch_].journal.size());
+    epoch_vector_[current_epoch_].reference_number += 1;
 }
 
 /**
-* \brief Update the current state with one from the history
+* \brief Update the current state with one from the history, which becomes
+*  the base of a new epoch
 */
 void QSSpreadingProcess::get_configuration_from_history()
 {
     size_t index = random_index_(gen_);
-    network_.set_configuration(history_vector_[index]);
+    size_t epoch = new_epoch();
+    if (replay_state_vector_.size() != network_.size())
+    {
+        replay_state_vector_.assign(network_.size(), 0);
+    }
+    replay(history_vector_[index], epoch_vector_[epoch].base,
+        replay_state_vector_);
+    network_.set_snapshot(epoch_vector_[epoch].base);
+    if (epoch_vector_[current_epoch_].reference_number == 0)
+    {
+        free_epoch_vector_.push_back(current_epoch_);
+    }
+    current_epoch_ = epoch;
+}
+
+/**
+* \brief Append the state change of an event to the journal of the current
+*  epoch. A new epoch is started once replaying the journal would cost more
+*  than copying the state.
+* \param[in] event event that just occurred
+*/
+void QSSpreadingProcess::journal_event(const Event& event)
+{
+    if (event.type == NULL_EVENT)
+    {
+        return;
+    }
+    HistoryEpoch& epoch = epoch_vector_[current_epoch_];
+    epoch.journal.emplace_back(event.node,
+        network_.get_state_vector()[event.node]);
+    if (epoch.journal.size() > epoch.base.Inode_vector.size()
+        + epoch.base.Rnode_vector.size() + MIN_JOURNAL_SIZE)
+    {
+        rebase_epoch();
+    }
+}
+
+/**
+* \brief Get an unused epoch, reusing the memory of released ones
+*/
+size_t QSSpreadingProcess::new_epoch()
+{
+    size_t epoch;
+    if (free_epoch_vector_.empty())
+    {
+        epoch = epoch_vector_.size();
+        epoch_vector_.emplace_back();
+    }
+    else
+    {
+        epoch = free_epoch_vector_.back();
+        free_epoch_vector_.pop_back();
+    }
+    epoch_vector_[epoch].journal.clear();
+    epoch_vector_[epoch].reference_number = 0;
+    return epoch;
+}
+
+/**
+* \brief Remove a reference to an epoch, which is released once unused
+* \param[in] epoch index of the epoch
+*/
+void QSSpreadingProcess::release_epoch(size_t epoch)
+{
+    epoch_vector_[epoch].reference_number -= 1;
+    if (epoch_vector_[epoch].reference_number == 0 and epoch != current_epoch_)
+    {
+        free_epoch_vector_.push_back(epoch);
+    }
+}
+
+/**
+* \brief Start a new epoch from the current state. The current epoch is
+*  overwritten if no history state refers to it.
+*/
+void QSSpreadingProcess::rebase_epoch()
+{
+    if (epoch_vector_[current_epoch_].reference_number > 0)
+    {
+        current_epoch_ = new_epoch();
+    }
+    HistoryEpoch& epoch = epoch_vector_[current_epoch_];
+    network_.get_snapshot(epoch.base);
+    epoch.journal.clear();
+}
+
+/**
+* \brief Rebuild a state of the history by applying the journal of its epoch
+*  to the base
+* \param[in] history_state state of the history
+* \param[out] snapshot snapshot to overwrite
+* \param[in] replay_state_vector state of each node, all 0 on entry and on
+*  exit
+*/
+void QSSpreadingProcess::replay(const HistoryState& history_state,
+    StateSnapshot& snapshot, vector<unsigned char>& replay_state_vector) const
+{
+    const HistoryEpoch& epoch = epoch_vector_[history_state.first];
+    size_t length = history_state.second;
+    if (length == 0)
+    {
+        snapshot.Inode_vector.assign(epoch.base.Inode_vector.begin(),
+            epoch.base.Inode_vector.end());
+        snapshot.Rnode_vector.assign(epoch.base.Rnode_vector.begin(),
+            epoch.base.Rnode_vector.end());
+        return;
+    }
+
+    for (NodeLabel node : epoch.base.Inode_vector)
+    {
+        replay_state_vector[node] = 1;
+    }
+    for (NodeLabel node : epoch.base.Rnode_vector)
+    {
+        replay_state_vector[node] = 2;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        replay_state_vector[epoch.journal[i].first] = epoch.journal[i].second;
+    }
+
+    //collect the nodes in their final state, clearing them on the way
+    snapshot.Inode_vector.clear();
+    snapshot.Rnode_vector.clear();
+    auto collect = [&](NodeLabel node)
+    {
+        if (replay_state_vector[node] == 1)
+        {
+            snapshot.Inode_vector.push_back(node);
+        }
+        else if (replay_state_vector[node] == 2)
+        {
+            snapshot.Rnode_vector.push_back(node);
+        }
+        replay_state_vector[node] = 0;
+    };
+    for (NodeLabel node : epoch.base.Inode_vector)
+    {
+        collect(node);
+    }
+    for (NodeLabel node : epoch.base.Rnode_vector)
+    {
+        collect(node);
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        collect(epoch.journal[i].first);
+    }
+}
+
+
+/**
+ * \brief Load a process saved with save
+ * \param[in] in input stream
+ */
+QSSpreadingProcess QSSpreadingProcess::load(istream& in)
+{
+    read_checkpoint_header(in, 1);
+    double transmission_rate = read_binary<double>(in);
+    double recovery_rate = read_binary<double>(in);
+    double waning_immunity_rate = read_binary<double>(in);
+    double base = read_binary<double>(in);
+    double update_history_rate = read_binary<double>(in);
+    unsigned int history_vector_size = read_binary<unsigned int>(in);
+    QSSpreadingProcess process(read_network(in), transmission_rate,
+            recovery_rate, waning_immunity_rate, base, update_history_rate,
+            history_vector_size);
+    process.load_state(in);
+    //each history state gets its own epoch
+    size_t history_size = read_binary<uint64_t>(in);
+    if (history_size > 0)
+    {
+        if (history_size != history_vector_size)
+        {
+            throw runtime_error("Saved history does not match the process");
+        }
+        process.initialize_history_vector();
+        for (auto& history_state : process.history_vector_)
+        {
+            size_t epoch = process.new_epoch();
+            StateSnapshot& snapshot = process.epoch_vector_[epoch].base;
+            snapshot.Inode_vector = read_binary_vector<NodeLabel>(in);
+            snapshot.Rnode_vector = read_binary_vector<NodeLabel>(in);
+            process.release_epoch(history_state.first);
+            history_state = HistoryState(epoch, 0);
+            process.epoch_vector_[epoch].reference_number = 1;
+        }
+        HistoryEpoch& current_epoch =
+            process.epoch_vector_[process.current_epoch_];
+        current_epoch.base.Inode_vector = read_binary_vector<NodeLabel>(in);
+        current_epoch.base.Rnode_vector = read_binary_vector<NodeLabel>(in);
+        current_epoch.journal =
+            read_binary_vector<pair<NodeLabel,StateLabel>>(in);
+    }
+    process.relaxation_time_ = read_binary<double>(in);
+    process.occupation_time_vector_ = read_binary_vector<double>(in);
+    process.absorption_number_ = read_binary<uint64_t>(in);
+    return process;
 }
 
+/**
+ * \brief Load a process from a binary file written by save
+ * \param[in] path path name to the file
+ */
+QSSpreadingProcess QSSpreadingProcess::load(const string& path)
+{
+    ifstream in(path, ios::in | ios::binary);
+    if (not in)
+    {
+        throw runtime_error("Cannot open file " + path);
+    }
+    return load(in);
+}
 
 }//end of namespace net
@@ -16,6 +16,33 @@
 namespace net
 {//start of namespace net
 
+//Define structure for the quasi-stationary estimates
+struct QSEstimate
+{
+    std::vector<double> distribution; //fraction of time with n infected nodes
+    double mean_prevalence;
+    double susceptibility; //N(<rho^2> - <rho>^2)/<rho>
+    double lifespan; //mean time between absorptions
+    double observation_time;
+    std::size_t absorption_number;
+};
+
+//Define structure for a segment of the history: a state and the journal of
+//the state changes that followed it
+struct HistoryEpoch
+{
+    StateSnapshot base;
+    std::vector<std::pair<NodeLabel,StateLabel>> journal;
+    unsigned int reference_number; //number of history states in the epoch
+};
+
+//Define state of the history: index of the epoch and number of journal
+//entries applied to its base
+typedef std::pair<std::size_t,std::size_t> HistoryState;
+
+QSEstimate qs_estimate(const std::vector<double>& occupation_time_vector,
+        std::size_t absorption_number, std::size_t size);
+
 /**
 * \class QSSpreadingProcess QSSpreadingProcess.hpp
 * \brief Quasi-stationary process class for the simulation of spreading
@@ -33,6 +60,31 @@ public:
         double base = 2,
         double update_history_rate = 1,
         unsigned int history_vector_size = 100);
+    QSSpreadingProcess(
+        const Network& network,
+        double transmission_rate,
+    	double recovery_rate,
+        double waning_immunity_rate,
+        double base = 2,
+        double update_history_rate = 1,
+        unsigned int history_vector_size = 100);
+
+    //Accessors
+    QSSpreadingProcess clone() const
+        {return *this;}
+    QSSpreadingProcess fork(unsigned int seed) const
+        {return QSSpreadingProcess(*this, seed);}
+    void save(std::ostream& out) const;
+    void save(const std::string& path) const;
+    double get_relaxation_time() const
+        {return relaxation_time_;}
+    QSEstimate get_qs_estimate() const
+        {return qs_estimate(occupation_time_vector_, absorption_number_,
+            network_.size());}
+    const std::vector<double>& get_occupation_time_vector() const
+        {return occupation_time_vector_;}
+    std::size_t get_absorption_number() const
+        {return absorption_number_;}
 
     //Mutators
     void initialize_random(double fraction, unsigned int seed);
@@ -45,6 +97,9 @@ public:
         const std::vector<NodeLabel>& Rnode_vector);
     void set_update_history_rate(double update_history_rate)
         {update_history_rate_ = update_history_rate;}
+    void set_relaxation_time(double relaxation_time)
+        {relaxation_time_ = relaxation_time;}
+    void reset_statistics();
 
     void reset();
     void evolve(double time_variation);
@@ -54,14 +109,21 @@ public:
         {throw std::runtime_error("Not implemented for QSSpreadingProcess");}
     void next_state()
         {throw std::runtime_error("Not implemented for QSSpreadingProcess");}
+    void set_transmission_output(const std::string& path,
+            std::size_t batch_size = 1 << 20)
+        {throw std::runtime_error("Not implemented for QSSpreadingProcess");}
+    void set_infection_recording(bool recording)
+        {throw std::runtime_error("Not implemented for QSSpreadingProcess");}
+    StopReason evolve_until(const StopCondition& condition)
+        {throw std::runtime_error("Not implemented for QSSpreadingProcess");}
 
-    std::vector<double> get_time_vector() const
+    const std::vector<double>& get_time_vector() const
     	{throw std::runtime_error("Not implemented for QSSpreadingProcess");
          return time_vector_;}
-    std::vector<unsigned int> get_Inode_number_vector() const
+    const std::vector<NodeLabel>& get_Inode_number_vector() const
     	{throw std::runtime_error("Not implemented for QSSpreadingProcess");
          return Inode_number_vector_;}
-    std::vector<unsigned int> get_Rnode_number_vector() const
+    const std::vector<NodeLabel>& get_Rnode_number_vector() const
         {throw std::runtime_error("Not implemented for QSSpreadingProcess");
     	 return Rnode_number_vector_;}
 
@@ -75,16 +137,37 @@ public:
         {throw std::runtime_error("Not implemented for QSSpreadingProcess");
          return std::vector<double>(); }
 
+    static QSSpreadingProcess load(std::istream& in);
+    static QSSpreadingProcess load(const std::string& path);
+
+protected:
+    QSSpreadingProcess(const QSSpreadingProcess& process, unsigned int seed);
+
 private:
-    std::vector<Configuration> history_vector_;
+    std::vector<HistoryState> history_vector_;
+    std::vector<HistoryEpoch> epoch_vector_; //reused once unreferenced
+    std::vector<std::size_t> free_epoch_vector_;
+    std::size_t current_epoch_; //epoch journaling the current state
+    std::vector<unsigned char> replay_state_vector_;
     double update_history_rate_;
     unsigned int history_vector_size_;
     std::uniform_int_distribution<int> random_index_;
+    double relaxation_time_; //time before the statistics are accumulated
+    std::vector<double> occupation_time_vector_; //time with n infected nodes
+    std::size_t absorption_number_;
 
     //private methods
     void initialize_history_vector();
+    void initialize_statistics();
+    void accumulate_statistics(double time, double duration);
     void update_history();
     void get_configuration_from_history();
+    void journal_event(const Event& event);
+    std::size_t new_epoch();
+    void release_epoch(std::size_t epoch);
+    void rebase_epoch();
+    void replay(const HistoryState& history_state, StateSnapshot& snapshot,
+        std::vector<unsigned char>& replay_state_vector) const;
 };
 
 
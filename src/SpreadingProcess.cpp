@@ -8,7 +8,10 @@
 
 #include <SpreadingProcess.hpp>
 #include <evolution.hpp>
+#include <io_data.hpp>
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <cmath>
 #include <exception>
 #include <stdexcept>
@@ -42,18 +45,62 @@ SpreadingProcess::SpreadingProcess(
     double waning_immunity_rate, double base) : network_(edge_list,
         transmission_rate, recovery_rate, waning_immunity_rate, base),
         time_vector_(), Inode_number_vector_(), Rnode_number_vector_(),
-        gen_(42), random_01_(0.,1.), transmission_vector_(), tracing_(false)
+        gen_(42), random_01_(0.,1.), transmission_vector_(), tracing_(false),
+        recording_(true), current_time_(0.), log_table_(get_log_table())
 {
-    // construct the log table
-    for (int i = 0; i < TABLE_SIZE; i++)
-    {
-        log_table_[i] = -log((i+0.5)/TABLE_SIZE);
-    }
+}
+
+/**
+* \brief Constructor of the class. The network structure is shared.
+* \param[in] network network on which the process takes place
+* \param[in] transmission_rate a double for the rate of transmission
+* \param[in] recovery_rate a double for the rate of recovery
+* \param[in] waning_immunity_rate a double for the rate a node gets immuned
+*/
+SpreadingProcess::SpreadingProcess(const Network& network,
+    double transmission_rate, double recovery_rate,
+    double waning_immunity_rate, double base) : network_(network,
+        transmission_rate, recovery_rate, waning_immunity_rate, base),
+        time_vector_(), Inode_number_vector_(), Rnode_number_vector_(),
+        gen_(42), random_01_(0.,1.), transmission_vector_(), tracing_(false),
+        recording_(true), current_time_(0.), log_table_(get_log_table())
+{
+}
+
+/**
+* \brief Constructor for a fork of a process. The network structure is shared
+*  and the dynamical state is copied, but the recorded trajectory restarts from
+*  the current state and the random number generator is reseeded. The seed
+*  also selects the stream of the generator, so forks with different seeds
+*  draw from distinct sequences.
+* \param[in] process process to fork
+* \param[in] seed seed and stream for the random number generator of the fork
+*/
+SpreadingProcess::SpreadingProcess(const SpreadingProcess& process,
+    unsigned int seed) : network_(process.network_),
+        time_vector_(), Inode_number_vector_(), Rnode_number_vector_(),
+        gen_(seed, seed), random_01_(process.random_01_),
+        transmission_vector_(), tracing_(process.tracing_),
+        recording_(process.recording_), current_time_(process.current_time_),
+        log_table_(process.log_table_),
+        transmission_writer_(), infection_recorder_(process.infection_recorder_)
+{
+    record_state();
 }
 
 /*---------------------------
  *    accessors
  *---------------------------*/
+/**
+ * \brief Copy of the process, without the transmission output
+ */
+SpreadingProcess SpreadingProcess::clone() const
+{
+    SpreadingProcess process(*this);
+    process.transmission_writer_.reset();
+    return process;
+}
+
 /**
  * \brief Verify if the network is in an absorbing state
  */
@@ -73,6 +120,96 @@ bool SpreadingProcess::is_absorbed()
     return is_absorbed;
 }
 
+/**
+ * \brief Save the complete process (parameters, network and dynamical
+ *  state) in binary form
+ * \param[in] out output stream
+ */
+void SpreadingProcess::save(ostream& out) const
+{
+    write_checkpoint_header(out, 0);
+    write_binary(out, network_.get_transmission_rate());
+    write_binary(out, network_.get_recovery_rate());
+    write_binary(out, network_.get_waning_immunity_rate());
+    write_binary(out, network_.get_base());
+    write_network(out, network_);
+    save_state(out);
+}
+
+/**
+ * \brief Save the complete process to a binary file
+ * \param[in] path path name to the file
+ */
+void SpreadingProcess::save(const string& path) const
+{
+    ofstream out(path, ios::out | ios::binary);
+    if (not out)
+    {
+        throw runtime_error("Cannot open file " + path);
+    }
+    save(out);
+}
+
+/**
+ * \brief Write the dynamical state of the process in binary form
+ * \param[in] out output stream
+ */
+void SpreadingProcess::save_state(ostream& out) const
+{
+    network_.save_state(out);
+    ostringstream gen_stream;
+    gen_stream << gen_;
+    string gen_string = gen_stream.str();
+    write_binary_vector(out, vector<char>(gen_string.begin(),
+                gen_string.end()));
+    write_binary_vector(out, time_vector_);
+    write_binary_vector(out, Inode_number_vector_);
+    write_binary_vector(out, Rnode_number_vector_);
+    write_binary_vector(out, transmission_vector_);
+    write_binary(out, tracing_);
+    write_binary(out, recording_);
+    write_binary(out, current_time_);
+}
+
+/**
+ * \brief Write the header of a checkpoint
+ * \param[in] out output stream
+ * \param[in] process_type integer identifying the class of the process
+ */
+void SpreadingProcess::write_checkpoint_header(ostream& out,
+        uint32_t process_type)
+{
+    write_binary(out, CHECKPOINT_MAGIC);
+    write_binary(out, CHECKPOINT_VERSION);
+    write_binary(out, process_type);
+    write_binary(out, static_cast<uint32_t>(sizeof(NodeLabel)));
+}
+
+/**
+ * \brief Read and validate the header of a checkpoint
+ * \param[in] in input stream
+ * \param[in] process_type integer identifying the class of the process
+ */
+void SpreadingProcess::read_checkpoint_header(istream& in,
+        uint32_t process_type)
+{
+    if (read_binary<uint32_t>(in) != CHECKPOINT_MAGIC)
+    {
+        throw runtime_error("Not a spreading_CR checkpoint");
+    }
+    if (read_binary<uint32_t>(in) != CHECKPOINT_VERSION)
+    {
+        throw runtime_error("Unsupported checkpoint version");
+    }
+    if (read_binary<uint32_t>(in) != process_type)
+    {
+        throw runtime_error("Checkpoint of another type of process");
+    }
+    if (read_binary<uint32_t>(in) != sizeof(NodeLabel))
+    {
+        throw runtime_error("Checkpoint written with another node label size");
+    }
+}
 
 /*---------------------------
  *     Mutators
@@ -85,9 +222,7 @@ void SpreadingProcess::initialize_random(double fraction, unsigned int seed)
 {
     gen_.seed(seed);
     infect_fraction(network_, fraction, gen_, random_01_);
-    time_vector_.push_back(0);
-    Inode_number_vector_.push_back(network_.get_Inode_number());
-    Rnode_number_vector_.push_back(network_.get_Rnode_number());
+    record_initial_state();
 }
 
 /**
@@ -97,14 +232,9 @@ void SpreadingProcess::initialize_random(double fraction, unsigned int seed)
 void SpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector,
         unsigned int seed)
 {
-    for (int i=0; i<Inode_vector.size(); i++)
-    {
-    	network_.infection(Inode_vector.at(i));
-    }
+    network_.infection(Inode_vector);
     gen_.seed(seed);
-    time_vector_.push_back(0);
-    Inode_number_vector_.push_back(network_.get_Inode_number());
-    Rnode_number_vector_.push_back(network_.get_Rnode_number());
+    record_initial_state();
 }
 
 /**
@@ -113,13 +243,8 @@ void SpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector,
 */
 void SpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector)
 {
-    for (int i=0; i<Inode_vector.size(); i++)
-    {
-    	network_.infection(Inode_vector.at(i));
-    }
-    time_vector_.push_back(0);
-    Inode_number_vector_.push_back(network_.get_Inode_number());
-    Rnode_number_vector_.push_back(network_.get_Rnode_number());
+    network_.infection(Inode_vector);
+    record_initial_state();
 }
 
 
@@ -132,18 +257,13 @@ void SpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector)
 void SpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector,
         const std::vector<NodeLabel>& Rnode_vector, unsigned int seed)
 {
-    for (int i=0; i<Inode_vector.size(); i++)
-    {
-    	network_.infection(Inode_vector.at(i));
-    }
-    for (int i=0; i<Rnode_vector.size(); i++)
+    network_.infection(Inode_vector);
+    for (size_t i=0; i<Rnode_vector.size(); i++)
     {
     	network_.set_recovered(Rnode_vector.at(i));
     }
     gen_.seed(seed);
-    time_vector_.push_back(0);
-    Inode_number_vector_.push_back(network_.get_Inode_number());
-    Rnode_number_vector_.push_back(network_.get_Rnode_number());
+    record_initial_state();
 }
 
 /**
@@ -155,19 +275,88 @@ void SpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector,
 void SpreadingProcess::initialize(const vector<NodeLabel>& Inode_vector,
         const std::vector<NodeLabel>& Rnode_vector)
 {
-    for (int i=0; i<Inode_vector.size(); i++)
+    network_.infection(Inode_vector);
+    for (size_t i=0; i<Rnode_vector.size(); i++)
     {
-    	network_.infection(Inode_vector.at(i));
+    	network_.set_recovered(Rnode_vector.at(i));
     }
-    for (int i=0; i<Rnode_vector.size(); i++)
+    record_initial_state();
+}
+
+
+/**
+* \brief Transfer the recorded trajectory to the vectors given in argument.
+*  The last recorded state is kept so that the process can go on.
+* \param[out] time_vector vector receiving the time of the events
+* \param[out] Inode_number_vector vector receiving the number of I nodes
+* \param[out] Rnode_number_vector vector receiving the number of R nodes
+*/
+void SpreadingProcess::release_trajectory(vector<double>& time_vector,
+        vector<NodeLabel>& Inode_number_vector,
+        vector<NodeLabel>& Rnode_number_vector)
+{
+    time_vector.swap(time_vector_);
+    Inode_number_vector.swap(Inode_number_vector_);
+    Rnode_number_vector.swap(Rnode_number_vector_);
+    time_vector_.clear();
+    Inode_number_vector_.clear();
+    Rnode_number_vector_.clear();
+    if (not time_vector.empty())
     {
-    	network_.set_recovered(Rnode_vector.at(i));
+        time_vector_.push_back(time_vector.back());
+        Inode_number_vector_.push_back(Inode_number_vector.back());
+        Rnode_number_vector_.push_back(Rnode_number_vector.back());
+    }
+}
+
+/**
+* \brief Stream the infection events (time, infecting node, infected node) to
+*  a binary file, readable with input_transmission_tree. The events of the
+*  following calls to next_state and evolve are written, until
+*  close_transmission_output is called.
+* \param[in] path path name to the output file
+* \param[in] batch_size number of bytes buffered before a write
+*/
+void SpreadingProcess::set_transmission_output(const string& path,
+        size_t batch_size)
+{
+    close_transmission_output();
+    transmission_writer_ = make_shared<TransmissionWriter>(path, batch_size);
+}
+
+/**
+* \brief Write the remaining infection events and close the transmission
+*  output, if any
+*/
+void SpreadingProcess::close_transmission_output()
+{
+    if (transmission_writer_)
+    {
+        shared_ptr<TransmissionWriter> writer = transmission_writer_;
+        transmission_writer_.reset();
+        writer->close();
     }
-    time_vector_.push_back(0);
-    Inode_number_vector_.push_back(network_.get_Inode_number());
-    Rnode_number_vector_.push_back(network_.get_Rnode_number());
 }
 
+/**
+* \brief Enable or disable the record of the time, infector and generation of
+*  the first infection of each node. When enabled, the record is cleared and
+*  the currently infected nodes are recorded as seeds. When disabled, the
+*  record is kept as is.
+* \param[in] recording true to enable
+*/
+void SpreadingProcess::set_infection_recording(bool recording)
+{
+    if (recording and not infection_recorder_.is_enabled())
+    {
+        infection_recorder_.enable(network_.size());
+        infection_recorder_.record_seeds(current_time_, network_);
+    }
+    else if (not recording)
+    {
+        infection_recorder_.disable();
+    }
+}
 
 /**
 * \brief Reset the process
@@ -178,7 +367,12 @@ void SpreadingProcess::reset()
     Rnode_number_vector_.clear();
     transmission_vector_.clear();
     time_vector_.clear();
+    current_time_ = 0;
     network_.reset();
+    if (infection_recorder_.is_enabled())
+    {
+        infection_recorder_.reset();
+    }
 }
 
 /**
@@ -186,41 +380,77 @@ void SpreadingProcess::reset()
 */
 void SpreadingProcess::next_state()
 {
-    if (not is_absorbed())
+    NullObserver observer;
+    next_state(observer);
+}
+
+/**
+* \brief Evolution of the process for an inclusive time variation
+* \param[in] time_variation double representing the time variation
+*/
+void SpreadingProcess::evolve(double time_variation)
+{
+    NullObserver observer;
+    evolve(time_variation, observer);
+}
+
+/**
+* \brief Evolution of the process until one of the stop conditions is met or
+*  an absorbing state is reached
+* \param[in] condition stop conditions
+* \return the reason for which the evolution stopped
+*/
+StopReason SpreadingProcess::evolve_until(const StopCondition& condition)
+{
+    NullObserver observer;
+    return evolve_until(condition, observer);
+}
+
+/**
+ * \brief Replace the dynamical state of the process by one written by
+ *  save_state
+ * \param[in] in input stream
+ */
+void SpreadingProcess::load_state(istream& in)
+{
+    network_.load_state(in);
+    vector<char> gen_string = read_binary_vector<char>(in);
+    istringstream gen_stream(string(gen_string.begin(), gen_string.end()));
+    gen_stream >> gen_;
+    time_vector_ = read_binary_vector<double>(in);
+    Inode_number_vector_ = read_binary_vector<NodeLabel>(in);
+    Rnode_number_vector_ = read_binary_vector<NodeLabel>(in);
+    transmission_vector_ = read_binary_vector<pair<NodeLabel,NodeLabel>>(in);
+    tracing_ = read_binary<bool>(in);
+    recording_ = read_binary<bool>(in);
+    current_time_ = read_binary<double>(in);
+}
+
+/**
+* \brief Append the current state to the trajectory, if it is recorded
+*/
+void SpreadingProcess::record_state()
+{
+    if (recording_)
     {
-	    double dt = 0;
-    	bool new_state = false;
-    	while (not new_state)
-    	{
-    	    dt += get_lifetime(network_, gen_, log_table_);
-    	    update_event(network_, gen_, random_01_, transmission_vector_,
-                    tracing_);
-            if (network_.get_Inode_number() != Inode_number_vector_.back()
-                    or network_.get_Rnode_number() != Rnode_number_vector_.back())
-    	    {
-    	        new_state = true;
-    	    }
-    	}
-        time_vector_.push_back(time_vector_.back()+dt);
+        time_vector_.push_back(current_time_);
         Inode_number_vector_.push_back(network_.get_Inode_number());
         Rnode_number_vector_.push_back(network_.get_Rnode_number());
     }
 }
 
 /**
-* \brief Evolution of the process for an inclusive time variation
-* \param[in] time_variation double representing the time variation
+* \brief Set the time to 0 and record the initial state; the infected nodes
+*  are recorded as seeds if the infection record is enabled
 */
-void SpreadingProcess::evolve(double time_variation)
+void SpreadingProcess::record_initial_state()
 {
-    double current_time_variation = 0;
-    while (current_time_variation < time_variation and not
-	   is_absorbed())
+    current_time_ = 0;
+    if (infection_recorder_.is_enabled())
     {
-	    next_state();
-    	current_time_variation += time_vector_.back()-
-		time_vector_[time_vector_.size()-2];
+        infection_recorder_.record_seeds(current_time_, network_);
     }
+    record_state();
 }
 
 pair<double,double> SpreadingProcess::estimate_R0(unsigned int sample,
@@ -230,13 +460,15 @@ pair<double,double> SpreadingProcess::estimate_R0(unsigned int sample,
     {
         throw MyException();
     }
-    bool initial_tracing = tracing_;
-    set_tracing(true);
+    //only the infections caused by the secondary node are counted
+    bool initial_recording = recording_;
+    set_trajectory_recording(false);
     gen_.seed(seed);
     vector<unsigned int> secondary_case_vector(sample,0);
     double R0_mean = 0.;
     double R0_std = 0.;
-    NodeLabel source_node, secondary_node;
+    NodeLabel source_node;
+    SecondaryCaseObserver observer;
     unsigned int i = 0;
     while (i < sample)
     {
@@ -245,7 +477,7 @@ pair<double,double> SpreadingProcess::estimate_R0(unsigned int sample,
         if (Rnode_vector.size() > 0)
         {
             //initialize manually
-            for (int i=0; i<Rnode_vector.size(); i++)
+            for (size_t i=0; i<Rnode_vector.size(); i++)
             {
                 network_.set_recovered(Rnode_vector.at(i));
             }
@@ -261,37 +493,30 @@ pair<double,double> SpreadingProcess::estimate_R0(unsigned int sample,
                 network_.infection(source_node);
             }
         }
-        time_vector_.push_back(0);
-        Inode_number_vector_.push_back(network_.get_Inode_number());
-        Rnode_number_vector_.push_back(network_.get_Rnode_number());
+        current_time_ = 0;
 
-	    next_state();
-        //check if node did transmit or died
-        if (transmission_vector_.size() > 0)
+        //the first event is either a transmission or the source recovery;
+        //samples are not sent to the transmission output
+        observer.reset(source_node);
+	    single_transition(observer);
+        if (observer.get_secondary_case_number() > 0)
         {
-            secondary_node = transmission_vector_.back().second;
-            while (network_.is_infected(secondary_node))
-            {
-                next_state();
-            }
-            //count the number of appearance of secondary node
-            for (int j = 0; j < transmission_vector_.size(); j++)
+            observer.reset(observer.get_last_secondary_node());
+            while (network_.is_infected(observer.get_node()))
             {
-                if (transmission_vector_[j].first == secondary_node)
-                {
-                    secondary_case_vector[i] += 1;
-                    R0_mean += 1;
-                }
+                single_transition(observer);
             }
+            secondary_case_vector[i] = observer.get_secondary_case_number();
+            R0_mean += observer.get_secondary_case_number();
             i += 1;
         }
     }
     reset();
-    set_tracing(initial_tracing);
+    set_trajectory_recording(initial_recording);
     R0_mean /= sample;
 
     //calculate std on R0
-    for (int j = 0; j < sample; j++)
+    for (unsigned int j = 0; j < sample; j++)
     {
         R0_std += ((secondary_case_vector[j] - R0_mean)
                 *(secondary_case_vector[j] - R0_mean));
@@ -312,6 +537,7 @@ vector<double> SpreadingProcess::final_size_sample(unsigned int sample,
     gen_.seed(seed);
     vector<NodeLabel> Inode_vector;
     vector<double> final_size_vector;
+    NullObserver observer;
     for (unsigned int i = 0; i < sample; i++)
     {
         reset();
@@ -319,7 +545,7 @@ vector<double> SpreadingProcess::final_size_sample(unsigned int sample,
         NodeLabel source_node = floor(random_01_(gen_)*network_.size());
         Inode_vector.push_back(source_node);
         initialize(Inode_vector);
-        evolve(numeric_limits<double>::infinity());
+        run_evolution(numeric_limits<double>::infinity(), observer);
         if (network_.final_size() > threshold)
         {
             final_size_vector.push_back(network_.final_size());
@@ -331,4 +557,88 @@ vector<double> SpreadingProcess::final_size_sample(unsigned int sample,
     return final_size_vector;
 }
 
+/**
+ * \brief Sample outbreaks of the SIR model from a random seed, classified as
+ *  major as soon as the number of infected and recovered nodes reaches a
+ *  threshold; only small outbreaks are evolved until absorption.
+ * \param[in] sample number of outbreaks
+ * \param[in] seed seed for the random number generator
+ * \param[in] major_threshold fraction of the nodes above which an outbreak
+ *  is major, in (0, 1]
+ */
+OutbreakSizeDistribution SpreadingProcess::outbreak_size_sample(
+        unsigned int sample, unsigned int seed, double major_threshold)
+{
+    if (not network_.is_SIR())
+    {
+        throw runtime_error("Must be SIR process");
+    }
+    if (not (major_threshold > 0 and major_threshold <= 1))
+    {
+        throw invalid_argument("The major threshold must be in (0, 1]");
+    }
+    bool initial_recording = recording_;
+    set_trajectory_recording(false);
+    gen_.seed(seed);
+    StopCondition condition;
+    condition.cumulative_threshold = ceil(major_threshold*network_.size());
+    OutbreakSizeDistribution distribution;
+    distribution.sample = sample;
+    distribution.major_number = 0;
+    distribution.small_size_histogram.assign(condition.cumulative_threshold,
+            0);
+    NullObserver observer;
+    for (unsigned int i = 0; i < sample; i++)
+    {
+        reset();
+        NodeLabel source_node = floor(random_01_(gen_)*network_.size());
+        network_.infection(source_node);
+        current_time_ = 0;
+        if (run_evolution_until(condition, observer) == CUMULATIVE_THRESHOLD)
+        {
+            distribution.major_number += 1;
+        }
+        else
+        {
+            distribution.small_size_histogram[network_.get_Rnode_number()]
+                += 1;
+        }
+    }
+    reset();
+    set_trajectory_recording(initial_recording);
+
+    return distribution;
+}
+
+/**
+ * \brief Load a process saved with save
+ * \param[in] in input stream
+ */
+SpreadingProcess SpreadingProcess::load(istream& in)
+{
+    read_checkpoint_header(in, 0);
+    double transmission_rate = read_binary<double>(in);
+    double recovery_rate = read_binary<double>(in);
+    double waning_immunity_rate = read_binary<double>(in);
+    double base = read_binary<double>(in);
+    SpreadingProcess process(read_network(in), transmission_rate,
+            recovery_rate, waning_immunity_rate, base);
+    process.load_state(in);
+    return process;
+}
+
+/**
+ * \brief Load a process from a binary file written by save
+ * \param[in] path path name to the file
+ */
+SpreadingProcess SpreadingProcess::load(const string& path)
+{
+    ifstream in(path, ios::in | ios::binary);
+    if (not in)
+    {
+        throw runtime_error("Cannot open file " + path);
+    }
+    return load(in);
+}
+
 }//end of namespace net
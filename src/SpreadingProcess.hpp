@@ -11,10 +11,57 @@
 
 #include <StaticNetworkSIR.hpp>
 #include <evolution.hpp>
+#include <Observer.hpp>
+#include <TransmissionWriter.hpp>
+#include <memory>
+#include <iostream>
+#include <string>
+#include <limits>
 
 namespace net
 {//start of namespace net
 
+//Binary checkpoint format
+constexpr const uint32_t CHECKPOINT_MAGIC = 0x52435053; //"SPCR"
+constexpr const uint32_t CHECKPOINT_VERSION = 5; //5: node label size
+
+//Define the reasons for which evolve_until stops
+enum StopReason
+{
+    ABSORBING_STATE,
+    TIME_LIMIT,
+    EVENT_LIMIT,
+    INODE_THRESHOLD, //number of infected nodes reached
+    RNODE_THRESHOLD, //number of recovered nodes reached
+    CUMULATIVE_THRESHOLD //number of infected and recovered nodes reached
+};
+
+//Define the conditions of evolve_until; the evolution stops as soon as one
+//of them is met. Unset conditions are never met.
+struct StopCondition
+{
+    StopCondition() :
+        time_variation(std::numeric_limits<double>::infinity()),
+        max_event_number(std::numeric_limits<std::size_t>::max()),
+        Inode_threshold(std::numeric_limits<std::size_t>::max()),
+        Rnode_threshold(std::numeric_limits<std::size_t>::max()),
+        cumulative_threshold(std::numeric_limits<std::size_t>::max()) {}
+    double time_variation; //inclusive, as for evolve
+    std::size_t max_event_number;
+    std::size_t Inode_threshold;
+    std::size_t Rnode_threshold;
+    std::size_t cumulative_threshold;
+};
+
+//Define structure for the outbreak size distribution of the SIR model
+struct OutbreakSizeDistribution
+{
+    std::size_t sample; //number of outbreaks
+    std::size_t major_number; //number of outbreaks reaching the threshold
+    std::vector<std::size_t> small_size_histogram; //number of small outbreaks
+                                                   //of each final size
+};
+
 /**
 * \class SpreadingProcess SpreadingProcess.hpp
 * \brief Process class for the simulation of spreading dynamics on networks.
@@ -29,13 +76,19 @@ public:
     	double recovery_rate,
         double waning_immunity_rate,
         double base = 2);
+    SpreadingProcess(
+        const Network& network,
+        double transmission_rate,
+    	double recovery_rate,
+        double waning_immunity_rate,
+        double base = 2);
 
     //Accessors
-    std::vector<double> get_time_vector() const
+    const std::vector<double>& get_time_vector() const
     	{return time_vector_;}
-    std::vector<unsigned int> get_Inode_number_vector() const
+    const std::vector<NodeLabel>& get_Inode_number_vector() const
     	{return Inode_number_vector_;}
-    std::vector<unsigned int> get_Rnode_number_vector() const
+    const std::vector<NodeLabel>& get_Rnode_number_vector() const
     	{return Rnode_number_vector_;}
     size_t get_Inode_number() const
         {return network_.get_Inode_number();}
@@ -43,18 +96,45 @@ public:
         {return network_.get_Rnode_number();}
     size_t get_size() const
         {return network_.size();}
+    double get_current_time() const
+        {return current_time_;}
     bool is_absorbed();
+    void save(std::ostream& out) const;
+    void save(const std::string& path) const;
+    SpreadingProcess clone() const;
+    SpreadingProcess fork(unsigned int seed) const
+        {return SpreadingProcess(*this, seed);}
 
-    const std::unordered_set<NodeLabel>& get_Snode_set() const
+    std::unordered_set<NodeLabel> get_Snode_set() const
         {return network_.get_Snode_set();}
-    const std::unordered_set<NodeLabel>& get_Inode_set() const
+    std::unordered_set<NodeLabel> get_Inode_set() const
         {return network_.get_Inode_set();}
-    const std::unordered_set<NodeLabel>& get_Rnode_set() const
+    std::unordered_set<NodeLabel> get_Rnode_set() const
         {return network_.get_Rnode_set();}
+    const std::vector<NodeLabel>& get_Snode_vector() const
+        {return network_.get_Snode_vector();}
+    const std::vector<NodeLabel>& get_Inode_vector() const
+        {return network_.get_Inode_vector();}
+    const std::vector<NodeLabel>& get_Rnode_vector() const
+        {return network_.get_Rnode_vector();}
+    const std::vector<StateLabel>& get_state_vector() const
+        {return network_.get_state_vector();}
+    const InfectionRecorder& get_infection_record() const
+        {return infection_recorder_;}
 
     //Mutators
     void set_tracing(bool tracing)
         {tracing_ = tracing;}
+    void set_trajectory_recording(bool recording)
+        {recording_ = recording;}
+    void set_transmission_output(const std::string& path,
+            std::size_t batch_size = 1 << 20);
+    void close_transmission_output();
+    void set_infection_recording(bool recording);
+    void set_rates(double transmission_rate, double recovery_rate,
+            double waning_immunity_rate)
+        {network_.set_rates(transmission_rate, recovery_rate,
+            waning_immunity_rate);}
     void initialize_random(double fraction, unsigned int seed);
     void initialize(const std::vector<NodeLabel>& Inode_vector,
             unsigned int seed);
@@ -67,28 +147,272 @@ public:
             const std::vector<NodeLabel>& Rnode_vector);
 
 
+    void release_trajectory(std::vector<double>& time_vector,
+            std::vector<NodeLabel>& Inode_number_vector,
+            std::vector<NodeLabel>& Rnode_number_vector);
+
     void reset();
     void next_state();
     void evolve(double time_variation);
+    template <class Observer>
+    void next_state(Observer& observer);
+    template <class Observer>
+    void evolve(double time_variation, Observer& observer);
+    StopReason evolve_until(const StopCondition& condition);
+    template <class Observer>
+    StopReason evolve_until(const StopCondition& condition,
+            Observer& observer);
     std::pair<double,double> estimate_R0(unsigned int sample,
             unsigned int seed = 42,
             const std::vector<NodeLabel>& Rnode_vector = std::vector<NodeLabel>());
     std::vector<double> final_size_sample(unsigned int sample, unsigned int seed,
             double threshold = 1e-4);
+    OutbreakSizeDistribution outbreak_size_sample(unsigned int sample,
+            unsigned int seed, double major_threshold = 0.01);
+
+    static SpreadingProcess load(std::istream& in);
+    static SpreadingProcess load(const std::string& path);
 
 protected:
+    SpreadingProcess(const SpreadingProcess& process, unsigned int seed);
+
     StaticNetworkSIR network_;
     RNGType gen_;
     std::uniform_real_distribution<double> random_01_;
-    double log_table_[TABLE_SIZE];
+    const double* log_table_; //shared table, see get_log_table
     //simulation results members
     std::vector<double> time_vector_;
-    std::vector<unsigned int> Inode_number_vector_;
-    std::vector<unsigned int> Rnode_number_vector_;
+    std::vector<NodeLabel> Inode_number_vector_;
+    std::vector<NodeLabel> Rnode_number_vector_;
     std::vector<std::pair<NodeLabel,NodeLabel>> transmission_vector_;
     bool tracing_;
+    bool recording_;
+    double current_time_;
+    std::shared_ptr<TransmissionWriter> transmission_writer_;
+    InfectionRecorder infection_recorder_;
+
+    //protected methods
+    void record_state();
+    void record_initial_state();
+    template <class Observer>
+    void single_transition(Observer& observer);
+    template <class Observer>
+    void run_evolution(double time_variation, Observer& observer);
+    template <class Observer>
+    StopReason run_evolution_until(const StopCondition& condition,
+            Observer& observer);
+    template <class Observer, class Call>
+    void call_with_outputs(Observer& observer, Call call);
+    template <class Observer, class Call>
+    void call_with_transmission_output(Observer& observer, Call call);
+
+    //calls to the evolution methods with a given observer type
+    struct TransitionCall
+    {
+        SpreadingProcess* process;
+        template <class Observer>
+        void operator()(Observer& observer)
+            {process->single_transition(observer);}
+    };
+    struct EvolutionCall
+    {
+        SpreadingProcess* process;
+        double time_variation;
+        template <class Observer>
+        void operator()(Observer& observer)
+            {process->run_evolution(time_variation, observer);}
+    };
+    struct EvolutionUntilCall
+    {
+        SpreadingProcess* process;
+        const StopCondition* condition;
+        StopReason* reason;
+        template <class Observer>
+        void operator()(Observer& observer)
+            {*reason = process->run_evolution_until(*condition, observer);}
+    };
+    void save_state(std::ostream& out) const;
+    void load_state(std::istream& in);
+    static void write_checkpoint_header(std::ostream& out,
+            uint32_t process_type);
+    static void read_checkpoint_header(std::istream& in,
+            uint32_t process_type);
 };
 
+/*---------------------------
+ *     Template methods
+ *---------------------------*/
+
+/**
+* \brief Evolution of the process for a single state transition
+* \param[in] observer observer called after the transition; its begin method
+*  must have been called beforehand
+*/
+template <class Observer>
+void SpreadingProcess::next_state(Observer& observer)
+{
+    TransitionCall call = {this};
+    call_with_outputs(observer, call);
+}
+
+/**
+* \brief Evolution of the process for an inclusive time variation
+* \param[in] time_variation double representing the time variation
+* \param[in] observer observer called for each state transition
+*/
+template <class Observer>
+void SpreadingProcess::evolve(double time_variation, Observer& observer)
+{
+    EvolutionCall call = {this, time_variation};
+    call_with_outputs(observer, call);
+}
+
+/**
+* \brief Evolution of the process until one of the stop conditions is met or
+*  an absorbing state is reached
+* \param[in] condition stop conditions
+* \param[in] observer observer called for each state transition
+* \return the reason for which the evolution stopped
+*/
+template <class Observer>
+StopReason SpreadingProcess::evolve_until(const StopCondition& condition,
+        Observer& observer)
+{
+    StopReason reason = ABSORBING_STATE;
+    EvolutionUntilCall call = {this, &condition, &reason};
+    call_with_outputs(observer, call);
+    return reason;
+}
+
+/**
+* \brief Call an evolution method with the observer combined with the
+*  enabled outputs (infection record, transmission output). The outputs are
+*  selected once per call, not at each transition.
+* \param[in] observer observer of the user
+* \param[in] call evolution method to call
+*/
+template <class Observer, class Call>
+void SpreadingProcess::call_with_outputs(Observer& observer, Call call)
+{
+    if (infection_recorder_.is_enabled())
+    {
+        ObserverPair<Observer,InfectionRecorder> observer_pair(observer,
+                infection_recorder_);
+        call_with_transmission_output(observer_pair, call);
+    }
+    else
+    {
+        call_with_transmission_output(observer, call);
+    }
+}
+
+/**
+* \brief Call an evolution method with the observer combined with the
+*  transmission output, if any
+* \param[in] observer observer
+* \param[in] call evolution method to call
+*/
+template <class Observer, class Call>
+void SpreadingProcess::call_with_transmission_output(Observer& observer,
+        Call call)
+{
+    if (transmission_writer_)
+    {
+        ObserverPair<Observer,TransmissionWriter> observer_pair(observer,
+                *transmission_writer_);
+        call(observer_pair);
+    }
+    else
+    {
+        call(observer);
+    }
+}
+
+/**
+* \brief Single state transition, reported to the observer only
+* \param[in] observer observer called after the transition
+*/
+template <class Observer>
+void SpreadingProcess::single_transition(Observer& observer)
+{
+    if (not is_absorbed())
+    {
+        double dt = 0;
+        Event event;
+        while (event.type == NULL_EVENT)
+        {
+            dt += get_lifetime(network_, gen_, log_table_);
+            event = update_event(network_, gen_, random_01_,
+                    transmission_vector_, tracing_);
+        }
+        current_time_ += dt;
+        observer(event, current_time_, network_);
+        record_state();
+    }
+}
+
+/**
+* \brief Evolution for an inclusive time variation, reported to the observer
+*  only
+* \param[in] time_variation double representing the time variation
+* \param[in] observer observer called for each state transition
+*/
+template <class Observer>
+void SpreadingProcess::run_evolution(double time_variation,
+        Observer& observer)
+{
+    double current_time_variation = 0;
+    observer.begin(current_time_, network_);
+    while (current_time_variation < time_variation and not
+	   is_absorbed())
+    {
+        double previous_time = current_time_;
+	    single_transition(observer);
+    	current_time_variation += current_time_ - previous_time;
+    }
+    observer.end(current_time_, network_);
+}
+
+/**
+* \brief Evolution until a stop condition is met, reported to the observer
+*  only
+* \param[in] condition stop conditions
+* \param[in] observer observer called for each state transition
+* \return the reason for which the evolution stopped
+*/
+template <class Observer>
+StopReason SpreadingProcess::run_evolution_until(
+        const StopCondition& condition, Observer& observer)
+{
+    double current_time_variation = 0;
+    std::size_t event_number = 0;
+    StopReason reason;
+    observer.begin(current_time_, network_);
+    while (true)
+    {
+        std::size_t Inode_number = network_.get_Inode_number();
+        std::size_t Rnode_number = network_.get_Rnode_number();
+        if (Inode_number >= condition.Inode_threshold)
+            {reason = INODE_THRESHOLD; break;}
+        if (Rnode_number >= condition.Rnode_threshold)
+            {reason = RNODE_THRESHOLD; break;}
+        if (Inode_number + Rnode_number >= condition.cumulative_threshold)
+            {reason = CUMULATIVE_THRESHOLD; break;}
+        if (is_absorbed())
+            {reason = ABSORBING_STATE; break;}
+        if (current_time_variation >= condition.time_variation)
+            {reason = TIME_LIMIT; break;}
+        if (event_number >= condition.max_event_number)
+            {reason = EVENT_LIMIT; break;}
+        double previous_time = current_time_;
+        single_transition(observer);
+        current_time_variation += current_time_ - previous_time;
+        event_number += 1;
+    }
+    observer.end(current_time_, network_);
+    return reason;
+}
+
 
 }//end of namespace net
 
@@ -7,7 +7,9 @@
 */
 
 #include <StaticNetworkSIR.hpp>
+#include <io_data.hpp>
 #include <iostream>
+#include <stdexcept>
 #include <algorithm>
 #include <utility>
 
@@ -32,176 +34,185 @@ namespace net
 StaticNetworkSIR::StaticNetworkSIR(
     vector<pair<NodeLabel, NodeLabel> >& edge_list,
     double transmission_rate, double recovery_rate,
-    double waning_immunity_rate, double base) :	Network(edge_list),
+    double waning_immunity_rate, double base) :
+    StaticNetworkSIR(Network(edge_list), transmission_rate, recovery_rate,
+        waning_immunity_rate, base)
+{
+}
+
+/**
+* \brief Constructor of the class. The adjacency list is shared with network.
+* \param[in] network network on which the process takes place
+* \param[in] transmission_rate double rate of transmission
+* \param[in] recovery_rate double rate of recovery for infected nodes
+* \param[in] waning_immunity_rate double rate at which recovered nodes
+* become susceptible again
+*/
+StaticNetworkSIR::StaticNetworkSIR(const Network& network,
+    double transmission_rate, double recovery_rate,
+    double waning_immunity_rate, double base) :	Network(network),
     state_vector_(Network::size(),0), Inode_number_(0), Rnode_number_(0),
     transmission_rate_(transmission_rate), recovery_rate_(recovery_rate),
     waning_immunity_rate_(waning_immunity_rate), event_tree_(), hash_(1.,1.),
     waning_group_(0),
     max_propensity_vector_(), propensity_group_map_(), mapping_vector_(),
     is_SI_(false), is_SIS_(false), is_SIRS_(false), is_SIR_(false), base_(base),
-    inert_node_vector_(), state_set_vector_(3,unordered_set<NodeLabel>())
+    state_node_vector_(3,vector<NodeLabel>()),
+    position_vector_(Network::size())
 {
-    //All nodes are susceptible initially
-    for (NodeLabel node = 0; node < size(); node++)
+    //All nodes are susceptible initially. The capacity of each state vector
+    //is reserved once so that its storage is never reallocated.
+    for (StateLabel state = 0; state < 3; state++)
     {
-        state_set_vector_[0].insert(node);
+        state_node_vector_[state].reserve(size());
     }
-
-    //Identify the model
-    if(recovery_rate_ == 0)
-    {
-        is_SI_ = true;
-    }
-    else
+    for (NodeLabel node = 0; node < size(); node++)
     {
-        if (waning_immunity_rate_ > 0)
-        {
-            if (std::isinf(waning_immunity_rate_))
-            {
-                is_SIS_ = true;
-            }
-            else
-            {
-                is_SIRS_ = true;
-            }
-        }
-        else
-        {
-            is_SIR_ = true;
-        }
+        position_vector_[node] = node;
+        state_node_vector_[0].push_back(node);
     }
 
-    //Determine minimal and maximal degree
-    size_t degree_min = degree(0);
-    size_t degree_max = degree(0);
-    for (int i = 0; i < size(); ++i)
-    {
-        if (degree(i) < degree_min)
-        {
-            degree_min = degree(i);
-        }
-        if (degree(i) > degree_max)
-        {
-            degree_max = degree(i);
-        }
-    }
+    build_propensity_structure();
+}
 
-    //Get min, max propensity and number of group
-    double propensity_max;
-    double propensity_min;
-    if(not is_SIRS_)
-    {
-        //SI, SIR or SIS dynamics
-        propensity_max = transmission_rate_*degree_max + recovery_rate_;
-        propensity_min = transmission_rate_*degree_min + recovery_rate_;
-    }
-    else
+/**
+* \brief Copy constructor of the class. The adjacency list is shared and the
+*  dynamical state is copied.
+* \param[in] network object to copy
+*/
+StaticNetworkSIR::StaticNetworkSIR(const StaticNetworkSIR& network) :
+    Network(network),
+    state_vector_(network.state_vector_),
+    Inode_number_(network.Inode_number_), Rnode_number_(network.Rnode_number_),
+    transmission_rate_(network.transmission_rate_),
+    recovery_rate_(network.recovery_rate_),
+    waning_immunity_rate_(network.waning_immunity_rate_),
+    event_tree_(network.event_tree_), hash_(network.hash_),
+    waning_group_(network.waning_group_),
+    max_propensity_vector_(network.max_propensity_vector_),
+    propensity_group_map_(network.propensity_group_map_),
+    mapping_vector_(network.mapping_vector_),
+    is_SI_(network.is_SI_), is_SIS_(network.is_SIS_),
+    is_SIRS_(network.is_SIRS_), is_SIR_(network.is_SIR_),
+    base_(network.base_),
+    state_node_vector_(3,vector<NodeLabel>()),
+    position_vector_(network.position_vector_)
+{
+    //preserve the reserved capacity of each state vector
+    for (StateLabel state = 0; state < 3; state++)
     {
-        //SIRS dynamics
-        propensity_max = max(transmission_rate_*degree_max + recovery_rate_,
-            waning_immunity_rate_);
-        propensity_min = min(transmission_rate_*degree_min + recovery_rate_,
-            waning_immunity_rate_);
+        state_node_vector_[state].reserve(size());
+        state_node_vector_[state].assign(
+            network.state_node_vector_[state].begin(),
+            network.state_node_vector_[state].end());
     }
-    size_t number_of_group = max(ceil(log2(propensity_max/propensity_min)/
-                log2(base_)),1.);
+}
 
-    //Initialize correct hash object, binary tree
-    hash_ = HashPropensity(propensity_min, propensity_max, base_);
-    event_tree_ = BinaryTree(number_of_group);
+/*---------------------------
+ *      Accessors
+ *---------------------------*/
 
-    //reserve size for each propensity group
-    for (size_t group_index = 0; group_index < number_of_group;
-        ++group_index)
+/**
+* \brief Copy the current configuration
+* \param[in] empty_configuration empty structure configuration
+*/
+void StaticNetworkSIR::get_configuration_copy(
+    Configuration& empty_configuration) const
+{
+    empty_configuration.state_set_vector.clear();
+    for (StateLabel state = 0; state < 3; state++)
     {
-        propensity_group_map_[group_index] = PropensityGroup();
-        propensity_group_map_[group_index].reserve(size());
+        empty_configuration.state_set_vector.emplace_back(
+            state_node_vector_[state].begin(), state_node_vector_[state].end());
     }
+}
 
-    //Initalize max propensity vector for each group
-    max_propensity_vector_.push_back(base_*propensity_min);
-    for (size_t group_index = 0; group_index < number_of_group-1;
-        ++group_index)
-    {
-        max_propensity_vector_.push_back(
-            base_*max_propensity_vector_[group_index]);
-    }
-    max_propensity_vector_.pop_back();
-    max_propensity_vector_.push_back(propensity_max);
+/**
+* \brief Copy the infected and recovered nodes in a snapshot. The vectors of
+*  the snapshot are overwritten in place, so their memory is reused.
+* \param[out] snapshot snapshot to overwrite
+*/
+void StaticNetworkSIR::get_snapshot(StateSnapshot& snapshot) const
+{
+    snapshot.Inode_vector.assign(state_node_vector_[1].begin(),
+        state_node_vector_[1].end());
+    snapshot.Rnode_vector.assign(state_node_vector_[2].begin(),
+        state_node_vector_[2].end());
+}
 
-    //Set mapping vector for the groups associated to infected nodes
-    mapping_vector_.resize(1+degree_max);
-    if (is_SIRS_)
+/**
+* \brief Write the dynamical state in binary form
+* \param[in] out output stream
+*/
+void StaticNetworkSIR::save_state(ostream& out) const
+{
+    for (StateLabel state = 0; state < 3; state++)
     {
-        waning_group_ = hash_(waning_immunity_rate_);
+        write_binary_vector(out, state_node_vector_[state]);
     }
-    for (int k = 0; k <= degree_max; k++)
+    //only the nodes are stored, the propensities are recomputed on load
+    write_binary(out, static_cast<uint64_t>(propensity_group_map_.size()));
+    for (GroupIndex group_index = 0;
+        group_index < propensity_group_map_.size(); group_index++)
     {
-        mapping_vector_[k] = hash_(transmission_rate_*k + recovery_rate_);
+        const PropensityGroup& propensity_group =
+            propensity_group_map_.at(group_index);
+        vector<NodeLabel> group_node_vector;
+        group_node_vector.reserve(propensity_group.size());
+        for (auto& element : propensity_group)
+        {
+            group_node_vector.push_back(element.first);
+        }
+        write_binary_vector(out, group_node_vector);
     }
+    write_binary_vector(out, event_tree_.get_value_vector());
 }
 
 /*---------------------------
- *      Accessors
+ *      Mutators
  *---------------------------*/
 
 /**
-* \brief Copy the current configuration
-* \param[in] empty_configuration empty structure configuration
+* \brief Change the rates of the process. The network must be in the state
+*  left by reset (no infected or recovered node).
+* \param[in] transmission_rate double rate of transmission
+* \param[in] recovery_rate double rate of recovery for infected nodes
+* \param[in] waning_immunity_rate double rate at which recovered nodes
+* become susceptible again
 */
-void StaticNetworkSIR::get_configuration_copy(
-    Configuration& empty_configuration) const
+void StaticNetworkSIR::set_rates(double transmission_rate,
+    double recovery_rate, double waning_immunity_rate)
 {
-    empty_configuration.state_set_vector = state_set_vector_;
+    if (Inode_number_ > 0 or Rnode_number_ > 0)
+    {
+        throw runtime_error("Rates can only be changed after a reset");
+    }
+    transmission_rate_ = transmission_rate;
+    recovery_rate_ = recovery_rate;
+    waning_immunity_rate_ = waning_immunity_rate;
+    build_propensity_structure();
 }
 
-/*---------------------------
- *      Mutators
- *---------------------------*/
-
 /**
-* \brief Reset the network to an absorbing state
+* \brief Reset the network to an absorbing state. The propensity groups are
+*  emptied in bulk, the event tree is zeroed once and only the infected and
+*  recovered nodes change state.
 */
 void StaticNetworkSIR::reset()
 {
-    //clean the event tree and propensity groups
-    if (event_tree_.get_value() > 0)
+    for (auto& element : propensity_group_map_)
     {
-        for (auto iter = propensity_group_map_.begin();
-            iter != propensity_group_map_.end(); iter ++)
-        {
-            GroupIndex group_index = iter->first;
-            while (not (iter->second).empty()) //assumes S nodes are not in groups
-            {
-                size_t in_group_index = (iter->second).size()-1;
-                if (is_infected(propensity_group_map_[group_index]
-                    [in_group_index].first))
-                {
-                    recovery(group_index, in_group_index);
-                }
-                else
-                {
-                    immunity_loss(group_index, in_group_index);
-                }
-            }
-        }
+        element.second.clear();
     }
-
-    if(is_SIR_)
+    for (StateLabel state = 1; state < 3; state++)
     {
-        //for SIR model, one needs to set manually recovered nodes to
-        //susceptible
-        while (not inert_node_vector_.empty())
+        while (not state_node_vector_[state].empty())
         {
-            Rnode_number_ -= 1;
-            state_vector_[inert_node_vector_.back()] = 0;
-            state_set_vector_[2].erase(inert_node_vector_.back());
-            state_set_vector_[0].insert(inert_node_vector_.back());
-            inert_node_vector_.pop_back();
+            set_state(state_node_vector_[state].back(), 0);
         }
     }
-
-    //make sure the binary tree have zero values everywhere
+    Inode_number_ = 0;
+    Rnode_number_ = 0;
     event_tree_.clear();
 }
 
@@ -211,15 +222,47 @@ void StaticNetworkSIR::reset()
 */
 void StaticNetworkSIR::infection(NodeLabel node)
 {
-    state_vector_[node] = 1;
+    set_state(node, 1);
     double propensity = transmission_rate_*degree(node) + recovery_rate_;
     GroupIndex group_index = mapping_vector_.at(degree(node));
     propensity_group_map_[group_index].push_back(
         pair<NodeLabel,double>(node,propensity));
     event_tree_.update_value(group_index, propensity);
     Inode_number_ += 1;
-    state_set_vector_[0].erase(node);
-    state_set_vector_[1].insert(node);
+}
+
+/**
+* \brief Change the state of multiple nodes from susceptible to infected. The
+*  event tree is updated once per propensity group; nodes that are not
+*  susceptible are ignored.
+* \param[in] node_vector vector of NodeLabel
+*/
+void StaticNetworkSIR::infection(const vector<NodeLabel>& node_vector)
+{
+    vector<double> variation_vector(event_tree_.get_number_of_leaves(), 0.);
+    for (NodeLabel node : node_vector)
+    {
+        if (not is_susceptible(node))
+        {
+            continue;
+        }
+        set_state(node, 1);
+        double propensity = transmission_rate_*degree(node) + recovery_rate_;
+        GroupIndex group_index = mapping_vector_[degree(node)];
+        propensity_group_map_[group_index].push_back(
+            pair<NodeLabel,double>(node,propensity));
+        variation_vector[group_index] += propensity;
+        Inode_number_ += 1;
+    }
+    for (GroupIndex group_index = 0; group_index < variation_vector.size();
+        group_index++)
+    {
+        if (variation_vector[group_index] > 0)
+        {
+            event_tree_.update_value(group_index,
+                variation_vector[group_index]);
+        }
+    }
 }
 
 /**
@@ -230,8 +273,7 @@ void StaticNetworkSIR::set_recovered(NodeLabel node)
 {
     if (is_SIR_ or is_SIRS_)
     {
-        state_vector_[node] = 2;
-        state_set_vector_[2].insert(node);
+        set_state(node, 2);
         Rnode_number_ += 1;
         if (is_SIRS_)
         {
@@ -240,10 +282,6 @@ void StaticNetworkSIR::set_recovered(NodeLabel node)
                 pair<NodeLabel,double>(node, waning_immunity_rate_));
             event_tree_.update_value(waning_group_, waning_immunity_rate_);
         }
-        else
-        {
-            inert_node_vector_.push_back(node);
-        }
     }
     else
     {
@@ -266,17 +304,14 @@ void StaticNetworkSIR::recovery(GroupIndex group_index,
     swap(propensity_group[in_group_index], propensity_group.back());
     propensity_group.pop_back();
     event_tree_.update_value(group_index, -propensity);
-    state_set_vector_[1].erase(node);
     if (is_SIS_)
     {
         //node gets susceptible instantly, no new propensity
-        state_vector_[node] = 0;
-        state_set_vector_[0].insert(node);
+        set_state(node, 0);
     }
     else
     {
-        state_vector_[node] = 2;
-        state_set_vector_[2].insert(node);
+        set_state(node, 2);
         Rnode_number_ += 1;
         if (is_SIRS_)
         {
@@ -285,10 +320,6 @@ void StaticNetworkSIR::recovery(GroupIndex group_index,
                 pair<NodeLabel,double>(node, waning_immunity_rate_));
             event_tree_.update_value(waning_group_, waning_immunity_rate_);
         }
-        else
-        {
-            inert_node_vector_.push_back(node);
-        }
     }
 }
 
@@ -302,13 +333,11 @@ void StaticNetworkSIR::immunity_loss(GroupIndex group_index,
 {
     PropensityGroup& propensity_group = propensity_group_map_[group_index];
     NodeLabel node = propensity_group[in_group_index].first;
-    state_vector_[node] = 0;
+    set_state(node, 0);
     swap(propensity_group[in_group_index], propensity_group.back());
     propensity_group.pop_back();
     event_tree_.update_value(group_index, -waning_immunity_rate_);
     Rnode_number_ -= 1;
-    state_set_vector_[2].erase(node);
-    state_set_vector_[0].insert(node);
 }
 
 /**
@@ -333,5 +362,261 @@ void StaticNetworkSIR::set_configuration(Configuration& configuration)
     }
 }
 
+/**
+* \brief Change the dynamical state for the one of a snapshot.
+*
+*  From a state without infected nodes (and, for the SIRS model, without
+*  recovered nodes), only the recovered nodes that differ from the snapshot
+*  change state, then the propensity groups and the event tree are filled in
+*  bulk. Any other state is first reset.
+* \param[in] snapshot snapshot obtained with get_snapshot
+*/
+void StaticNetworkSIR::set_snapshot(const StateSnapshot& snapshot)
+{
+    if (Inode_number_ > 0 or (is_SIRS_ and Rnode_number_ > 0))
+    {
+        reset();
+    }
+    //remove the rounding errors left by the previous updates
+    event_tree_.clear();
+
+    //move the recovered nodes of the snapshot at the front of the recovered
+    //nodes, the others are the ones to make susceptible
+    vector<NodeLabel>& Rnode_vector = state_node_vector_[2];
+    size_t Rnode_number = 0;
+    for (NodeLabel node : snapshot.Rnode_vector)
+    {
+        if (is_susceptible(node))
+        {
+            set_state(node, 2);
+        }
+        NodeLabel other_node = Rnode_vector[Rnode_number];
+        Rnode_vector[position_vector_[node]] = other_node;
+        position_vector_[other_node] = position_vector_[node];
+        Rnode_vector[Rnode_number] = node;
+        position_vector_[node] = Rnode_number;
+        Rnode_number += 1;
+    }
+    while (Rnode_vector.size() > Rnode_number)
+    {
+        set_state(Rnode_vector.back(), 0);
+    }
+    Rnode_number_ = Rnode_number;
+    if (is_SIRS_ and Rnode_number_ > 0)
+    {
+        //recovered nodes can become again susceptible
+        PropensityGroup& waning_group = propensity_group_map_[waning_group_];
+        for (NodeLabel node : Rnode_vector)
+        {
+            waning_group.push_back(
+                pair<NodeLabel,double>(node, waning_immunity_rate_));
+        }
+        event_tree_.update_value(waning_group_,
+            Rnode_number_*waning_immunity_rate_);
+    }
+
+    infection(snapshot.Inode_vector);
+}
+
+/**
+* \brief Replace the dynamical state by one written by save_state. The
+*  process must have the same network and parameters.
+* \param[in] in input stream
+*/
+void StaticNetworkSIR::load_state(istream& in)
+{
+    //node vectors of each state, from which the state is recovered
+    vector<vector<NodeLabel>> state_node_vector(3);
+    size_t number_of_node = 0;
+    for (StateLabel state = 0; state < 3; state++)
+    {
+        state_node_vector[state] = read_binary_vector<NodeLabel>(in);
+        number_of_node += state_node_vector[state].size();
+    }
+    if (number_of_node != size())
+    {
+        throw runtime_error("Saved state does not match the network size");
+    }
+    for (StateLabel state = 0; state < 3; state++)
+    {
+        state_node_vector_[state].assign(state_node_vector[state].begin(),
+            state_node_vector[state].end());
+        for (size_t position = 0; position < state_node_vector[state].size();
+            position++)
+        {
+            NodeLabel node = state_node_vector[state][position];
+            if (node >= size())
+            {
+                throw runtime_error("Saved state contains invalid nodes");
+            }
+            state_vector_[node] = state;
+            position_vector_[node] = position;
+        }
+    }
+    Inode_number_ = state_node_vector_[1].size();
+    Rnode_number_ = state_node_vector_[2].size();
+
+    //propensity groups and event tree
+    if (read_binary<uint64_t>(in) != propensity_group_map_.size())
+    {
+        throw runtime_error("Saved state does not match the process");
+    }
+    for (GroupIndex group_index = 0;
+        group_index < propensity_group_map_.size(); group_index++)
+    {
+        PropensityGroup& propensity_group = propensity_group_map_[group_index];
+        propensity_group.clear();
+        for (NodeLabel node : read_binary_vector<NodeLabel>(in))
+        {
+            if (node >= size())
+            {
+                throw runtime_error("Saved state contains invalid nodes");
+            }
+            double propensity = is_infected(node) ?
+                transmission_rate_*degree(node) + recovery_rate_ :
+                waning_immunity_rate_;
+            propensity_group.push_back(
+                pair<NodeLabel,double>(node,propensity));
+        }
+    }
+    vector<double> value_vector = read_binary_vector<double>(in);
+    if (value_vector.size() != 2*event_tree_.get_number_of_leaves()-1)
+    {
+        throw runtime_error("Saved state does not match the process");
+    }
+    event_tree_.set_value_vector(value_vector);
+}
+
+/**
+* \brief Move a node to a new state, keeping the node vectors of each state
+*  consistent in constant time
+* \param[in] node node label
+* \param[in] state new state of the node
+*/
+void StaticNetworkSIR::set_state(NodeLabel node, StateLabel state)
+{
+    //swap-remove the node from the vector of its current state
+    vector<NodeLabel>& old_node_vector = state_node_vector_[state_vector_[node]];
+    NodeLabel last_node = old_node_vector.back();
+    old_node_vector[position_vector_[node]] = last_node;
+    position_vector_[last_node] = position_vector_[node];
+    old_node_vector.pop_back();
+    //append it to the vector of its new state
+    position_vector_[node] = state_node_vector_[state].size();
+    state_node_vector_[state].push_back(node);
+    state_vector_[node] = state;
+}
+
+
+/**
+* \brief Build the propensity groups, the mapping of the degrees to the groups
+*  and the event tree for the current rates. All propensity groups must be
+*  empty.
+*/
+void StaticNetworkSIR::build_propensity_structure()
+{
+    //Identify the model
+    is_SI_ = false;
+    is_SIS_ = false;
+    is_SIRS_ = false;
+    is_SIR_ = false;
+    if(recovery_rate_ == 0)
+    {
+        is_SI_ = true;
+    }
+    else
+    {
+        if (waning_immunity_rate_ > 0)
+        {
+            if (std::isinf(waning_immunity_rate_))
+            {
+                is_SIS_ = true;
+            }
+            else
+            {
+                is_SIRS_ = true;
+            }
+        }
+        else
+        {
+            is_SIR_ = true;
+        }
+    }
+
+    //Determine minimal and maximal degree
+    size_t degree_min = degree(0);
+    size_t degree_max = degree(0);
+    for (size_t i = 0; i < size(); ++i)
+    {
+        if (degree(i) < degree_min)
+        {
+            degree_min = degree(i);
+        }
+        if (degree(i) > degree_max)
+        {
+            degree_max = degree(i);
+        }
+    }
+
+    //Get min, max propensity and number of group
+    double propensity_max;
+    double propensity_min;
+    if(not is_SIRS_)
+    {
+        //SI, SIR or SIS dynamics
+        propensity_max = transmission_rate_*degree_max + recovery_rate_;
+        propensity_min = transmission_rate_*degree_min + recovery_rate_;
+    }
+    else
+    {
+        //SIRS dynamics
+        propensity_max = max(transmission_rate_*degree_max + recovery_rate_,
+            waning_immunity_rate_);
+        propensity_min = min(transmission_rate_*degree_min + recovery_rate_,
+            waning_immunity_rate_);
+    }
+    size_t number_of_group = max(ceil(log2(propensity_max/propensity_min)/
+                log2(base_)),1.);
+
+    //Initialize correct hash object, binary tree
+    hash_ = HashPropensity(propensity_min, propensity_max, base_);
+    event_tree_ = BinaryTree(number_of_group);
+
+    //reserve size for each propensity group; the groups already allocated
+    //are kept
+    for (size_t group_index = 0; group_index < number_of_group;
+        ++group_index)
+    {
+        propensity_group_map_[group_index].reserve(size());
+    }
+    while (propensity_group_map_.size() > number_of_group)
+    {
+        propensity_group_map_.erase(propensity_group_map_.size()-1);
+    }
+
+    //Initalize max propensity vector for each group
+    max_propensity_vector_.clear();
+    max_propensity_vector_.push_back(base_*propensity_min);
+    for (size_t group_index = 0; group_index < number_of_group-1;
+        ++group_index)
+    {
+        max_propensity_vector_.push_back(
+            base_*max_propensity_vector_[group_index]);
+    }
+    max_propensity_vector_.pop_back();
+    max_propensity_vector_.push_back(propensity_max);
+
+    //Set mapping vector for the groups associated to infected nodes
+    mapping_vector_.resize(1+degree_max);
+    waning_group_ = 0;
+    if (is_SIRS_)
+    {
+        waning_group_ = hash_(waning_immunity_rate_);
+    }
+    for (size_t k = 0; k <= degree_max; k++)
+    {
+        mapping_vector_[k] = hash_(transmission_rate_*k + recovery_rate_);
+    }
+}
 
 }//end of namespace net
@@ -16,6 +16,7 @@
 #include <unordered_set>
 #include <cmath>
 #include <memory>
+#include <iostream>
 
 namespace net
 {//start of namespace net
@@ -31,6 +32,14 @@ struct Configuration
     std::vector<std::unordered_set<NodeLabel>> state_set_vector;
 };
 
+//Define compact structure for a dynamical state: only the infected and
+//recovered nodes are stored, the other nodes are susceptible
+struct StateSnapshot
+{
+    std::vector<NodeLabel> Inode_vector;
+    std::vector<NodeLabel> Rnode_vector;
+};
+
 /**
 * \class StaticNetworkSIR StaticNetworkSIR.hpp
 * \brief Framework for the establishement of propagation dynamics on static
@@ -43,6 +52,11 @@ public:
     StaticNetworkSIR(std::vector<std::pair<NodeLabel, NodeLabel> >& edge_list,
         double transmission_rate, double recovery_rate,
         double waning_immunity_rate, double base = 2);
+    StaticNetworkSIR(const Network& network,
+        double transmission_rate, double recovery_rate,
+        double waning_immunity_rate, double base = 2);
+    StaticNetworkSIR(const StaticNetworkSIR& network);
+    StaticNetworkSIR(StaticNetworkSIR&& network) = default;
 
     //Accessors
     const bool is_susceptible(NodeLabel node)
@@ -51,12 +65,23 @@ public:
         {return state_vector_[node] == 1;}
     const bool is_recovered(NodeLabel node)
         {return state_vector_[node] == 2;}
-    const std::unordered_set<NodeLabel>& get_Snode_set() const
-        {return state_set_vector_.at(0);}
-    const std::unordered_set<NodeLabel>& get_Inode_set() const
-        {return state_set_vector_.at(1);}
-    const std::unordered_set<NodeLabel>& get_Rnode_set() const
-        {return state_set_vector_.at(2);}
+    const std::vector<StateLabel>& get_state_vector() const
+        {return state_vector_;}
+    const std::vector<NodeLabel>& get_Snode_vector() const
+        {return state_node_vector_[0];}
+    const std::vector<NodeLabel>& get_Inode_vector() const
+        {return state_node_vector_[1];}
+    const std::vector<NodeLabel>& get_Rnode_vector() const
+        {return state_node_vector_[2];}
+    std::unordered_set<NodeLabel> get_Snode_set() const
+        {return std::unordered_set<NodeLabel>(state_node_vector_[0].begin(),
+            state_node_vector_[0].end());}
+    std::unordered_set<NodeLabel> get_Inode_set() const
+        {return std::unordered_set<NodeLabel>(state_node_vector_[1].begin(),
+            state_node_vector_[1].end());}
+    std::unordered_set<NodeLabel> get_Rnode_set() const
+        {return std::unordered_set<NodeLabel>(state_node_vector_[2].begin(),
+            state_node_vector_[2].end());}
 
     const bool is_SI() const
         {return is_SI_;}
@@ -73,6 +98,8 @@ public:
         {return recovery_rate_;}
     double get_waning_immunity_rate() const
         {return waning_immunity_rate_;}
+    double get_base() const
+        {return base_;}
     double prevalence() const
         {return ((1.*Inode_number_)/Network::size());}
     double final_size() const
@@ -86,16 +113,23 @@ public:
     const PropensityGroup& get_propensity_group(GroupIndex group_index) const
         {return propensity_group_map_.at(group_index);}
     void get_configuration_copy(Configuration& empty_configuration) const;
+    void get_snapshot(StateSnapshot& snapshot) const;
     double get_max_propensity(GroupIndex group_index) const
         {return max_propensity_vector_[group_index];}
+    void save_state(std::ostream& out) const;
 
     //Mutators
     void reset();
+    void set_rates(double transmission_rate, double recovery_rate,
+        double waning_immunity_rate);
     void infection(NodeLabel node);
+    void infection(const std::vector<NodeLabel>& node_vector);
     void recovery(GroupIndex group_index, size_t in_group_index);
     void immunity_loss(GroupIndex group_index, size_t in_group_index);
     void set_recovered(NodeLabel node);
     void set_configuration(Configuration& configuration);
+    void set_snapshot(const StateSnapshot& snapshot);
+    void load_state(std::istream& in);
 
 private:
     //Unvarying members
@@ -113,13 +147,16 @@ private:
     std::vector<GroupIndex> mapping_vector_;
     //Varying members
     std::vector<StateLabel> state_vector_;
-    std::vector<std::unordered_set<NodeLabel>> state_set_vector_;
-    std::vector<NodeLabel> inert_node_vector_;
+    std::vector<std::vector<NodeLabel>> state_node_vector_; //nodes per state
+    std::vector<NodeLabel> position_vector_; //position in state_node_vector_
     BinaryTree event_tree_;
     std::unordered_map<GroupIndex,PropensityGroup> propensity_group_map_;
     std::size_t Inode_number_;
     std::size_t Rnode_number_;
 
+    //private methods
+    void set_state(NodeLabel node, StateLabel state);
+    void build_propensity_structure();
 };
 
 }//end of namespace net
@@ -0,0 +1,198 @@
+/**
+* \file TransmissionWriter.cpp
+* \brief Methods for the class TransmissionWriter
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#include <TransmissionWriter.hpp>
+#include <io_data.hpp>
+#include <stdexcept>
+#include <exception>
+
+using namespace std;
+
+namespace net
+{//start of namespace net
+
+/**
+ * \brief Append an unsigned integer as a varint
+ * \param[in] buffer byte buffer
+ * \param[in] value integer to encode
+ */
+static void append_varint(vector<char>& buffer, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+/*---------------------------
+ *      Constructor
+ *---------------------------*/
+
+/**
+* \brief Constructor of the class
+* \param[in] path path name to the output file, overwritten if it exists
+* \param[in] batch_size number of bytes buffered before a write
+*/
+TransmissionWriter::TransmissionWriter(const string& path,
+        size_t batch_size) :
+    out_(path, ios::out | ios::binary), batch_size_(batch_size),
+    record_number_(0), time_(0.), buffer_(), pending_buffer_(),
+    closing_(false), failed_(false), mutex_(), condition_(), thread_()
+{
+    if (not out_)
+    {
+        throw runtime_error("Cannot open file " + path);
+    }
+    write_binary(out_, TRANSMISSION_MAGIC);
+    write_binary(out_, TRANSMISSION_VERSION);
+    buffer_.reserve(batch_size_ + 32);
+    pending_buffer_.reserve(batch_size_ + 32);
+    thread_ = thread(&TransmissionWriter::write_loop, this);
+}
+
+/*---------------------------
+ *      Destructor
+ *---------------------------*/
+
+TransmissionWriter::~TransmissionWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (...) {}
+}
+
+/*---------------------------
+ *      Mutators
+ *---------------------------*/
+
+/**
+* \brief Add a transmission to the file
+* \param[in] time time of the infection
+* \param[in] source infecting node
+* \param[in] node infected node
+*/
+void TransmissionWriter::write(double time, NodeLabel source, NodeLabel node)
+{
+    float time_difference = static_cast<float>(time - time_);
+    time_ += time_difference;
+    const char* bytes = reinterpret_cast<const char*>(&time_difference);
+    buffer_.insert(buffer_.end(), bytes, bytes + sizeof(float));
+    append_varint(buffer_, source);
+    append_varint(buffer_, node);
+    record_number_ += 1;
+    if (buffer_.size() >= batch_size_)
+    {
+        submit_buffer();
+    }
+}
+
+/**
+* \brief Write all the buffered records to the file
+*/
+void TransmissionWriter::flush()
+{
+    if (not thread_.joinable())
+    {
+        return;
+    }
+    if (buffer_.size() > 0)
+    {
+        submit_buffer();
+    }
+    unique_lock<mutex> lock(mutex_);
+    condition_.wait(lock, [this]{return pending_buffer_.empty();});
+    out_.flush();
+    if (failed_ or not out_)
+    {
+        throw runtime_error("Failed to write transmission file");
+    }
+}
+
+/**
+* \brief Write the remaining records, stop the writing thread and close the
+*  file
+*/
+void TransmissionWriter::close()
+{
+    if (not thread_.joinable())
+    {
+        return;
+    }
+    //the thread must be joined even if the flush fails
+    exception_ptr error;
+    try
+    {
+        flush();
+    }
+    catch (...)
+    {
+        error = current_exception();
+    }
+    {
+        lock_guard<mutex> lock(mutex_);
+        closing_ = true;
+    }
+    condition_.notify_all();
+    thread_.join();
+    out_.close();
+    if (error)
+    {
+        rethrow_exception(error);
+    }
+}
+
+/**
+* \brief Hand over the current buffer to the writing thread, once it is done
+*  with the previous one
+*/
+void TransmissionWriter::submit_buffer()
+{
+    {
+        unique_lock<mutex> lock(mutex_);
+        condition_.wait(lock, [this]{return pending_buffer_.empty();});
+        if (failed_)
+        {
+            throw runtime_error("Failed to write transmission file");
+        }
+        swap(buffer_, pending_buffer_);
+    }
+    condition_.notify_all();
+}
+
+/**
+* \brief Main loop of the writing thread
+*/
+void TransmissionWriter::write_loop()
+{
+    unique_lock<mutex> lock(mutex_);
+    while (true)
+    {
+        condition_.wait(lock, [this]
+            {return closing_ or not pending_buffer_.empty();});
+        if (pending_buffer_.empty())
+        {
+            break; //closing
+        }
+        //the main thread does not touch the pending buffer until it is empty
+        lock.unlock();
+        out_.write(pending_buffer_.data(), pending_buffer_.size());
+        lock.lock();
+        if (not out_)
+        {
+            failed_ = true;
+        }
+        pending_buffer_.clear();
+        condition_.notify_all();
+    }
+}
+
+}//end of namespace net
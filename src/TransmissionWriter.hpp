@@ -0,0 +1,99 @@
+/**
+* \file TransmissionWriter.hpp
+* \brief Header file for class TransmissionWriter
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#ifndef TRANSMISSIONWRITER_HPP_
+#define TRANSMISSIONWRITER_HPP_
+
+#include <Observer.hpp>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+namespace net
+{//start of namespace net
+
+//Transmission tree file format
+constexpr const uint32_t TRANSMISSION_MAGIC = 0x54545053; //"SPTT"
+constexpr const uint32_t TRANSMISSION_VERSION = 1;
+
+/*
+ * A transmission file starts with the magic number and the version (uint32),
+ * followed by one record per infection event:
+ *
+ *   float32 time difference with the previous record
+ *   varint  infecting node
+ *   varint  infected node
+ *
+ * The time difference is taken with respect to the time reconstructed from
+ * the previous float32 differences, so that rounding errors do not
+ * accumulate. Varints are little-endian base 128 (7 bits per byte, high bit
+ * set on all bytes but the last).
+ */
+
+/**
+* \class TransmissionWriter TransmissionWriter.hpp
+* \brief Observer streaming the infection events to a binary file.
+*
+* Records are encoded in a buffer; full buffers are written to the file by
+* a background thread while the next one is filled.
+*/
+class TransmissionWriter
+{
+public:
+    //Constructor
+    TransmissionWriter(const std::string& path,
+            std::size_t batch_size = 1 << 20);
+    TransmissionWriter(const TransmissionWriter&) = delete;
+    TransmissionWriter& operator=(const TransmissionWriter&) = delete;
+
+    //Destructor
+    ~TransmissionWriter();
+
+    //Accessors
+    std::size_t get_record_number() const
+        {return record_number_;}
+
+    //Mutators
+    void begin(double time, const StaticNetworkSIR& net) {}
+    void operator()(const Event& event, double time,
+        const StaticNetworkSIR& net)
+    {
+        if (event.type == INFECTION_EVENT)
+        {
+            write(time, event.source, event.node);
+        }
+    }
+    void end(double time, const StaticNetworkSIR& net) {}
+    void write(double time, NodeLabel source, NodeLabel node);
+    void flush();
+    void close();
+
+private:
+    std::ofstream out_;
+    std::size_t batch_size_;
+    std::size_t record_number_;
+    double time_; //time reconstructed from the written differences
+    std::vector<char> buffer_;
+    std::vector<char> pending_buffer_;
+    bool closing_;
+    bool failed_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::thread thread_;
+
+    void submit_buffer();
+    void write_loop();
+};
+
+}//end of namespace net
+
+#endif /* TRANSMISSIONWRITER_HPP_ */
@@ -1,14 +1,135 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 #include <SpreadingProcess.hpp>
 #include <QSSpreadingProcess.hpp>
+#include <Observer.hpp>
+#include <splitting.hpp>
+#include <sweep.hpp>
+#include <percolation.hpp>
+#include <io_data.hpp>
+#include <generators.hpp>
+#include <compaction.hpp>
+#include <sstream>
 
 using namespace std;
 using namespace net;
 
 namespace py = pybind11;
 
-PYBIND11_MODULE(spreading_CR, m)
+/*
+ * Read-only NumPy view on a vector owned by a C++ object. The memory is not
+ * copied; the array holds a reference to owner to keep it alive. Only for
+ * vectors never reallocated after construction, such as the node states.
+ */
+template <typename T>
+py::array_t<T> array_view(const vector<T>& data, py::handle owner)
+{
+    py::array_t<T> array(data.size(), data.data(), owner);
+    array.attr("setflags")(py::arg("write") = false);
+    return array;
+}
+
+/*
+ * NumPy array taking ownership of the content of a vector, without copy.
+ */
+template <typename T>
+py::array_t<T> array_move(vector<T>&& data)
+{
+    vector<T>* data_ptr = new vector<T>(move(data));
+    py::capsule owner(data_ptr, [](void* ptr)
+        {delete reinterpret_cast<vector<T>*>(ptr);});
+    return py::array_t<T>(data_ptr->size(), data_ptr->data(), owner);
+}
+
+typedef py::array_t<bool, py::array::c_style | py::array::forcecast> BoolArray;
+
+/*
+ * Nodes selected by a boolean mask over all the nodes.
+ */
+vector<NodeLabel> mask_node_vector(BoolArray mask, size_t size)
+{
+    if (mask.ndim() != 1 or mask.size() != size)
+    {
+        throw py::value_error("The mask must have one entry per node");
+    }
+    vector<NodeLabel> node_vector;
+    const bool* data = mask.data();
+    for (size_t node = 0; node < size; node++)
+    {
+        if (data[node])
+        {
+            node_vector.push_back(node);
+        }
+    }
+    return node_vector;
+}
+
+/*
+ * Observer forwarding the calls to a python list of built-in observers.
+ */
+class ObserverList
+{
+public:
+    ObserverList(py::list observer_list)
+    {
+        for (auto item : observer_list)
+        {
+            if (py::isinstance<MeanPrevalenceObserver>(item))
+                {mean_.push_back(item.cast<MeanPrevalenceObserver*>());}
+            else if (py::isinstance<PeakPrevalenceObserver>(item))
+                {peak_.push_back(item.cast<PeakPrevalenceObserver*>());}
+            else if (py::isinstance<InfectedHistogramObserver>(item))
+                {histogram_.push_back(item.cast<InfectedHistogramObserver*>());}
+            else if (py::isinstance<ReproductionNumberObserver>(item))
+                {reproduction_.push_back(
+                    item.cast<ReproductionNumberObserver*>());}
+            else
+                {throw py::type_error("Unknown observer type");}
+        }
+    }
+
+    void begin(double time, const StaticNetworkSIR& net)
+    {
+        for (auto observer : mean_) {observer->begin(time, net);}
+        for (auto observer : peak_) {observer->begin(time, net);}
+        for (auto observer : histogram_) {observer->begin(time, net);}
+        for (auto observer : reproduction_) {observer->begin(time, net);}
+    }
+    void operator()(const Event& event, double time,
+        const StaticNetworkSIR& net)
+    {
+        for (auto observer : mean_) {(*observer)(event, time, net);}
+        for (auto observer : peak_) {(*observer)(event, time, net);}
+        for (auto observer : histogram_) {(*observer)(event, time, net);}
+        for (auto observer : reproduction_) {(*observer)(event, time, net);}
+    }
+    void end(double time, const StaticNetworkSIR& net)
+    {
+        for (auto observer : mean_) {observer->end(time, net);}
+        for (auto observer : peak_) {observer->end(time, net);}
+        for (auto observer : histogram_) {observer->end(time, net);}
+        for (auto observer : reproduction_) {observer->end(time, net);}
+    }
+
+private:
+    vector<MeanPrevalenceObserver*> mean_;
+    vector<PeakPrevalenceObserver*> peak_;
+    vector<InfectedHistogramObserver*> histogram_;
+    vector<ReproductionNumberObserver*> reproduction_;
+};
+
+/*
+ * The module built with 64-bit node labels has another name, so that both
+ * can be imported together.
+ */
+#ifdef SPREADING_CR_LABEL64
+#define SPREADING_CR_MODULE spreading_CR_64
+#else
+#define SPREADING_CR_MODULE spreading_CR
+#endif
+
+PYBIND11_MODULE(SPREADING_CR_MODULE, m)
 {
     m.doc() = R"pbdoc(
         SpreadingProcess
@@ -21,17 +142,219 @@ PYBIND11_MODULE(spreading_CR, m)
         .. autosummary::
            :toctree: _generate
 
+           Network
+           load_edge_list
+           load_labeled_edge_list
+           relabeled_network
+           simple_network
+           erdos_renyi_network
+           configuration_model_network
+           chung_lu_network
+           barabasi_albert_network
+           output_network_file
+           input_network_file
+           input_network_permutation
+           module_for_size
            SpreadingProcess.__init__
            SpreadingProcess.get_time_vector
            SpreadingProcess.get_Inode_number_vector
            SpreadingProcess.get_Rnode_number_vector
+           SpreadingProcess.release_trajectory
+           SpreadingProcess.get_state_vector
+           SpreadingProcess.set_infection_recording
            SpreadingProcess.is_absorbed
            SpreadingProcess.initialize
            SpreadingProcess.reset
            SpreadingProcess.next_state
            SpreadingProcess.evolve
+           SpreadingProcess.evolve_until
+           MeanPrevalenceObserver
+           PeakPrevalenceObserver
+           InfectedHistogramObserver
+           ReproductionNumberObserver
+           multilevel_splitting
+           rate_sweep
+           bond_percolation
+           read_transmission_tree
     )pbdoc";
 
+    m.attr("label_bits") = 8*sizeof(NodeLabel);
+
+    m.def("module_for_size", [](size_t size)
+        {
+            if (size <= size_t(numeric_limits<uint32_t>::max()))
+            {
+                return py::module::import("spreading_CR");
+            }
+            return py::module::import("spreading_CR_64");
+        }, R"pbdoc(
+        Returns the module to use for a network of a given size: spreading_CR,
+        with 32-bit node labels, up to 2**32 - 1 nodes, and spreading_CR_64,
+        with 64-bit node labels, for larger networks. Both modules have the
+        same content; the 64-bit one uses twice the memory for the network
+        and the node vectors.
+
+        Args:
+           size: Number of nodes.
+        )pbdoc", py::arg("size"));
+
+    /* =====================================
+     * Observers
+     * =====================================*/
+
+    py::class_<MeanPrevalenceObserver>(m, "MeanPrevalenceObserver")
+        .def(py::init<>(), R"pbdoc(
+            Time-weighted average of the prevalence, accumulated over the
+            calls to evolve where it is given.
+            )pbdoc")
+
+        .def("get_mean_prevalence",
+            &MeanPrevalenceObserver::get_mean_prevalence, R"pbdoc(
+            Returns the time-weighted average of the prevalence.
+            )pbdoc")
+
+        .def("get_duration", &MeanPrevalenceObserver::get_duration, R"pbdoc(
+            Returns the total duration observed.
+            )pbdoc")
+
+        .def("reset", &MeanPrevalenceObserver::reset, R"pbdoc(
+            Reset the accumulated statistics.
+            )pbdoc");
+
+    py::class_<PeakPrevalenceObserver>(m, "PeakPrevalenceObserver")
+        .def(py::init<>(), R"pbdoc(
+            Maximal prevalence and the time at which it is reached.
+            )pbdoc")
+
+        .def("get_peak_prevalence",
+            &PeakPrevalenceObserver::get_peak_prevalence, R"pbdoc(
+            Returns the maximal prevalence.
+            )pbdoc")
+
+        .def("get_peak_Inode_number",
+            &PeakPrevalenceObserver::get_peak_Inode_number, R"pbdoc(
+            Returns the maximal number of infected nodes.
+            )pbdoc")
+
+        .def("get_peak_time", &PeakPrevalenceObserver::get_peak_time, R"pbdoc(
+            Returns the time at which the maximal prevalence is reached.
+            )pbdoc")
+
+        .def("reset", &PeakPrevalenceObserver::reset, R"pbdoc(
+            Reset the peak.
+            )pbdoc");
+
+    py::class_<InfectedHistogramObserver>(m, "InfectedHistogramObserver")
+        .def(py::init<>(), R"pbdoc(
+            Time spent with each number of infected nodes.
+            )pbdoc")
+
+        .def("get_histogram", [](const InfectedHistogramObserver& observer)
+            {return array_move(vector<double>(observer.get_histogram()));},
+            R"pbdoc(
+            Returns a copy of the time spent with n infected nodes, for
+            n = 0,...,N.
+            )pbdoc")
+
+        .def("reset", &InfectedHistogramObserver::reset, R"pbdoc(
+            Reset the histogram.
+            )pbdoc");
+
+    py::class_<ReproductionNumberObserver>(m, "ReproductionNumberObserver")
+        .def(py::init<double>(), R"pbdoc(
+            Effective reproduction number R_t, binned by infection time. The
+            secondary cases of a node are attributed to the bin of its
+            infection time when it recovers. Nodes still infected are not
+            counted.
+
+            Args:
+               bin_width: Width of the time bins, positive and finite.
+            )pbdoc", py::arg("bin_width") = 1.)
+
+        .def("get_reproduction_number_array", [](
+            const ReproductionNumberObserver& observer)
+            {return array_move(observer.get_reproduction_number_vector());},
+            R"pbdoc(
+            Returns the mean number of secondary cases of the recovered nodes
+            infected in each bin [k*bin_width, (k+1)*bin_width), NaN for
+            empty bins.
+            )pbdoc")
+
+        .def("get_case_number_array", [](
+            const ReproductionNumberObserver& observer)
+            {return array_move(vector<size_t>(
+                observer.get_case_number_vector()));}, R"pbdoc(
+            Returns the number of recovered nodes infected in each bin.
+            )pbdoc")
+
+        .def("get_secondary_case_number_array", [](
+            const ReproductionNumberObserver& observer)
+            {return array_move(vector<size_t>(
+                observer.get_secondary_case_number_vector()));}, R"pbdoc(
+            Returns the total number of secondary cases of the recovered nodes
+            infected in each bin.
+            )pbdoc")
+
+        .def("reset", &ReproductionNumberObserver::reset, R"pbdoc(
+            Reset the estimator, before observing a new realization.
+            )pbdoc");
+
+    py::enum_<StopReason>(m, "StopReason")
+        .value("ABSORBING_STATE", ABSORBING_STATE)
+        .value("TIME_LIMIT", TIME_LIMIT)
+        .value("EVENT_LIMIT", EVENT_LIMIT)
+        .value("INODE_THRESHOLD", INODE_THRESHOLD)
+        .value("RNODE_THRESHOLD", RNODE_THRESHOLD)
+        .value("CUMULATIVE_THRESHOLD", CUMULATIVE_THRESHOLD);
+
+    /* =====================================
+     * Network
+     * =====================================*/
+
+    py::class_<Network>(m, "Network")
+        .def(py::init<vector<pair<NodeLabel, NodeLabel> >&>(), R"pbdoc(
+            Build a network from an edge list. The nodes are labeled from 0 to
+            the largest label of the list.
+
+            Args:
+               edge_list: Edge list of the network.
+            )pbdoc", py::arg("edge_list"))
+
+        .def("size", &Network::size, R"pbdoc(
+            Returns the number of nodes.
+            )pbdoc")
+
+        .def("degree", &Network::degree, R"pbdoc(
+            Returns the number of neighbors of a node.
+
+            Args:
+               node: Label of the node.
+            )pbdoc", py::arg("node"))
+
+        .def("get_edge_number", [](const Network& network)
+            {return network.get_neighbor_number()/2;}, R"pbdoc(
+            Returns the number of edges, each self-loop being counted once.
+            )pbdoc")
+
+        .def("get_neighbor_vector", [](py::object self, NodeLabel node)
+            {
+                const Network& network = self.cast<const Network&>();
+                if (node >= network.size())
+                {
+                    throw py::index_error("Node label out of range");
+                }
+                NeighborRange range = network.get_neighbor_vector(node);
+                py::array_t<NodeLabel> array(range.size(), range.begin(),
+                    self);
+                array.attr("setflags")(py::arg("write") = false);
+                return array;
+            }, R"pbdoc(
+            Returns a read-only view on the neighbors of a node.
+
+            Args:
+               node: Label of the node.
+            )pbdoc", py::arg("node"));
+
     py::class_<SpreadingProcess>(m, "SpreadingProcess")
         .def(py::init<vector<pair<NodeLabel, NodeLabel> >&,
             double, double, double, double>(), R"pbdoc(
@@ -49,18 +372,114 @@ PYBIND11_MODULE(spreading_CR, m)
             py::arg("recovery_rate"), py::arg("waning_immunity_rate"),
             py::arg("base") = 2)
 
-        .def("get_time_vector", &SpreadingProcess::get_time_vector, R"pbdoc(
+        .def(py::init<const Network&, double, double, double, double>(),
+            R"pbdoc(
+            Constructor from a Network, shared with the process without copy.
+            )pbdoc", py::arg("network"), py::arg("transmission_rate"),
+            py::arg("recovery_rate"), py::arg("waning_immunity_rate"),
+            py::arg("base") = 2)
+
+        .def("get_time_vector", [](const SpreadingProcess& sp)
+            {return array_move(vector<double>(sp.get_time_vector()));},
+            R"pbdoc(
             Returns the vector of time at which events took place.
+
+            The array is a copy, since the internal storage is reallocated as
+            the process evolves; release_trajectory moves it without copy.
+            )pbdoc")
+
+        .def("get_Inode_number_vector", [](const SpreadingProcess& sp)
+            {return array_move(vector<NodeLabel>(
+                sp.get_Inode_number_vector()));}, R"pbdoc(
+            Returns the vector of number of infected nodes for each event, as a
+            copy (see get_time_vector).
+            )pbdoc")
+
+        .def("get_Rnode_number_vector", [](const SpreadingProcess& sp)
+            {return array_move(vector<NodeLabel>(
+                sp.get_Rnode_number_vector()));}, R"pbdoc(
+            Returns the vector of number of recovered nodes for each event, as a
+            copy (see get_time_vector).
+            )pbdoc")
+
+        .def("release_trajectory", [](SpreadingProcess& sp)
+            {
+                vector<double> time_vector;
+                vector<NodeLabel> Inode_number_vector;
+                vector<NodeLabel> Rnode_number_vector;
+                sp.release_trajectory(time_vector, Inode_number_vector,
+                        Rnode_number_vector);
+                return py::make_tuple(array_move(move(time_vector)),
+                        array_move(move(Inode_number_vector)),
+                        array_move(move(Rnode_number_vector)));
+            }, R"pbdoc(
+            Returns the time, Inode number and Rnode number vectors as arrays
+            owning their memory, without copy. Only the last state is kept in
+            the process, which can keep evolving.
             )pbdoc")
 
-        .def("get_Inode_number_vector",
-            &SpreadingProcess::get_Inode_number_vector, R"pbdoc(
-            Returns the vector of number of infected nodes for each event.
+        .def("get_state_vector", [](py::object self)
+            {return array_view(self.cast<const SpreadingProcess&>()
+                .get_state_vector(), self);}, R"pbdoc(
+            Returns the state of each node (0: S, 1: I, 2: R).
+
+            The array is a read-only view on the internal storage that always
+            reflects the current state of the process.
+            )pbdoc")
+
+        .def("set_rates", &SpreadingProcess::set_rates, R"pbdoc(
+            Change the rates of the process without rebuilding the network.
+            The process must be in the state left by reset.
+
+            Args:
+               transmission_rate: Rate of transmission per edge.
+               recovery_rate: Rate of recovery of infected nodes.
+               waning_immunity_rate: Rate for immunity loss.
+            )pbdoc", py::arg("transmission_rate"), py::arg("recovery_rate"),
+            py::arg("waning_immunity_rate"))
+
+        .def("set_infection_recording",
+            &SpreadingProcess::set_infection_recording, R"pbdoc(
+            Enable or disable the record of the time, infector and generation
+            of the first infection of each node. When enabled, the record is
+            cleared and the currently infected nodes are recorded as seeds
+            (generation 0, no infector). It is disabled by default.
+
+            Args:
+               recording: Boolean.
+            )pbdoc", py::arg("recording"))
+
+        .def("get_infection_time_array", [](py::object self)
+            {return array_view(self.cast<const SpreadingProcess&>()
+                .get_infection_record().get_infection_time_vector(), self);},
+            R"pbdoc(
+            Returns the time of the first infection of each node (NaN if the
+            node was never infected) as a read-only view on the record.
+            )pbdoc")
+
+        .def("get_infector_array", [](py::object self)
+            {return array_view(self.cast<const SpreadingProcess&>()
+                .get_infection_record().get_infector_vector(), self);},
+            R"pbdoc(
+            Returns the infector of the first infection of each node as a
+            read-only view on the record. Seeds and nodes never infected have
+            the maximal value of the array type.
+            )pbdoc")
+
+        .def("get_generation_array", [](py::object self)
+            {return array_view(self.cast<const SpreadingProcess&>()
+                .get_infection_record().get_generation_vector(), self);},
+            R"pbdoc(
+            Returns the generation of the first infection of each node (0 for
+            seeds and nodes never infected) as a read-only view on the record.
             )pbdoc")
 
-        .def("get_Rnode_number_vector",
-            &SpreadingProcess::get_Rnode_number_vector, R"pbdoc(
-            Returns the vector of number of recovered nodes for each event.
+        .def("get_infected_node_array", [](py::object self)
+            {return array_view(self.cast<const SpreadingProcess&>()
+                .get_infection_record().get_infected_node_vector(), self);},
+            R"pbdoc(
+            Returns the nodes recorded so far, in order of first infection, as
+            a read-only view on the record.
             )pbdoc")
 
         .def("get_Inode_number",
@@ -91,14 +510,55 @@ PYBIND11_MODULE(spreading_CR, m)
             Returns the current set of recovered nodes.
             )pbdoc")
 
+        .def("get_Snode_array", [](py::object self)
+            {return array_view(self.cast<const SpreadingProcess&>()
+                .get_Snode_vector(), self);}, R"pbdoc(
+            Returns the current susceptible nodes as an array of node labels.
+
+            The array is a read-only view on the internal storage, only valid
+            until the process is modified again; use numpy.copy to keep it.
+            )pbdoc")
+
+        .def("get_Inode_array", [](py::object self)
+            {return array_view(self.cast<const SpreadingProcess&>()
+                .get_Inode_vector(), self);}, R"pbdoc(
+            Returns the current infected nodes as an array of node labels.
+
+            The array is a read-only view on the internal storage, only valid
+            until the process is modified again; use numpy.copy to keep it.
+            )pbdoc")
+
+        .def("get_Rnode_array", [](py::object self)
+            {return array_view(self.cast<const SpreadingProcess&>()
+                .get_Rnode_vector(), self);}, R"pbdoc(
+            Returns the current recovered nodes as an array of node labels.
+
+            The array is a read-only view on the internal storage, only valid
+            until the process is modified again; use numpy.copy to keep it.
+            )pbdoc")
+
         .def("initialize_random", &SpreadingProcess::initialize_random, R"pbdoc(
-            Initialize the spreading process with randomly infected nodes.
+            Initialize the spreading process with randomly infected nodes, drawn
+            without replacement among the susceptible nodes.
 
             Args:
                fraction: Initial fraction of infected nodes.
                seed: Integer seed for the random number generator.
             )pbdoc", py::arg("fraction"), py::arg("seed"))
 
+        .def("initialize_mask", [](SpreadingProcess& sp,
+                BoolArray mask, unsigned int seed)
+            {sp.initialize(mask_node_vector(mask, sp.get_size()), seed);},
+            R"pbdoc(
+            Initialize the spreading process with the infected nodes given by a
+            boolean mask.
+
+            Args:
+               mask: Boolean array with one entry per node, True for the
+                   initially infected nodes.
+               seed: Integer seed for the random number generator.
+            )pbdoc", py::arg("mask"), py::arg("seed"))
+
         .def("initialize", (void (SpreadingProcess::*)(const vector<NodeLabel>&,
             unsigned int)) &SpreadingProcess::initialize, R"pbdoc(
             Initialize the spreading process.
@@ -141,18 +601,112 @@ PYBIND11_MODULE(spreading_CR, m)
             Reset the spreading process. It needs to be initialized again.
             )pbdoc")
 
-        .def("next_state", &SpreadingProcess::next_state, R"pbdoc(
+        .def("next_state", (void (SpreadingProcess::*)())
+            &SpreadingProcess::next_state, R"pbdoc(
             Makes a Monte-Carlo step--the state of the system has changed due
             to a transmission, recovery or loss of immunity event.
             )pbdoc")
 
-        .def("evolve", &SpreadingProcess::evolve, R"pbdoc(
+        .def("evolve", (void (SpreadingProcess::*)(double))
+            &SpreadingProcess::evolve, R"pbdoc(
             Let the system evolve for a time duration.
 
             Args:
                time_variation: Time duration for the simulation.
             )pbdoc", py::arg("time_variation"))
 
+        .def("evolve", [](SpreadingProcess& sp, double time_variation,
+                py::list observer_list)
+            {
+                ObserverList observer(observer_list);
+                sp.evolve(time_variation, observer);
+            }, R"pbdoc(
+            Let the system evolve for a time duration, while updating
+            statistics on the fly.
+
+            Args:
+               time_variation: Time duration for the simulation.
+               observer_list: List of observers (MeanPrevalenceObserver,
+                   PeakPrevalenceObserver, InfectedHistogramObserver,
+                   ReproductionNumberObserver).
+            )pbdoc", py::arg("time_variation"), py::arg("observer_list"))
+
+        .def("evolve_until", [](SpreadingProcess& sp, double time_variation,
+                size_t max_event_number, size_t Inode_threshold,
+                size_t Rnode_threshold, size_t cumulative_threshold,
+                py::list observer_list)
+            {
+                StopCondition condition;
+                condition.time_variation = time_variation;
+                condition.max_event_number = max_event_number;
+                condition.Inode_threshold = Inode_threshold;
+                condition.Rnode_threshold = Rnode_threshold;
+                condition.cumulative_threshold = cumulative_threshold;
+                if (observer_list.size() == 0)
+                {
+                    return sp.evolve_until(condition);
+                }
+                ObserverList observer(observer_list);
+                return sp.evolve_until(condition, observer);
+            }, R"pbdoc(
+            Let the system evolve until one of the stop conditions is met or an
+            absorbing state is reached. The conditions are checked in C++
+            before each event; unset conditions are never met.
+
+            Args:
+               time_variation: Maximal time duration (inclusive, as for
+                   evolve).
+               max_event_number: Maximal number of events.
+               Inode_threshold: Stop when the number of infected nodes reaches
+                   this value.
+               Rnode_threshold: Stop when the number of recovered nodes reaches
+                   this value.
+               cumulative_threshold: Stop when the number of infected and
+                   recovered nodes reaches this value.
+               observer_list: List of observers, as for evolve.
+
+            Returns:
+               The StopReason for which the evolution stopped.
+            )pbdoc",
+            py::arg("time_variation") = numeric_limits<double>::infinity(),
+            py::arg("max_event_number") = numeric_limits<size_t>::max(),
+            py::arg("Inode_threshold") = numeric_limits<size_t>::max(),
+            py::arg("Rnode_threshold") = numeric_limits<size_t>::max(),
+            py::arg("cumulative_threshold") = numeric_limits<size_t>::max(),
+            py::arg("observer_list") = py::list())
+
+        .def("set_trajectory_recording",
+            &SpreadingProcess::set_trajectory_recording, R"pbdoc(
+            Enable or disable the recording of the trajectory (time, Inode
+            number and Rnode number vectors). It is enabled by default.
+
+            Args:
+               recording: Boolean.
+            )pbdoc", py::arg("recording"))
+
+        .def("get_current_time", &SpreadingProcess::get_current_time, R"pbdoc(
+            Returns the current time of the process.
+            )pbdoc")
+
+        .def("set_transmission_output",
+            &SpreadingProcess::set_transmission_output, R"pbdoc(
+            Stream the infection events of the following evolution to a
+            compact binary file, written by a background thread. Each event is
+            stored as a float32 time difference and two varint node labels.
+            Read the file with read_transmission_tree once
+            close_transmission_output has been called.
+
+            Args:
+               path: Path to the output file, overwritten if it exists.
+               batch_size: Number of bytes buffered before a write.
+            )pbdoc", py::arg("path"), py::arg("batch_size") = 1 << 20)
+
+        .def("close_transmission_output",
+            &SpreadingProcess::close_transmission_output, R"pbdoc(
+            Write the remaining infection events and close the transmission
+            output file.
+            )pbdoc")
+
         .def("estimate_R0", &SpreadingProcess::estimate_R0, R"pbdoc(
             Estimate the basic reproduction number.
 
@@ -170,7 +724,511 @@ PYBIND11_MODULE(spreading_CR, m)
                sample: Integer for the number of samples to draw.
                seed: Integer seed for the random number generator.
                threshold: Double for min final size to keep.
-            )pbdoc", py::arg("sample"), py::arg("seed"), py::arg("threshold") = 1e-4);
+            )pbdoc", py::arg("sample"), py::arg("seed"), py::arg("threshold") = 1e-4)
+
+        .def("outbreak_size_sample", [](SpreadingProcess& sp,
+                unsigned int sample, unsigned int seed, double major_threshold)
+            {
+                OutbreakSizeDistribution distribution;
+                {
+                    py::gil_scoped_release release;
+                    distribution = sp.outbreak_size_sample(sample, seed,
+                            major_threshold);
+                }
+                return py::make_tuple(
+                        (1.*distribution.major_number)/distribution.sample,
+                        array_move(move(distribution.small_size_histogram)));
+            }, R"pbdoc(
+            Sample outbreaks of the SIR model from a random infected node. An
+            outbreak is declared major, and stopped, as soon as the number of
+            infected and recovered nodes reaches the threshold; small
+            outbreaks are evolved until absorption.
+
+            Args:
+               sample: Integer for the number of outbreaks.
+               seed: Integer seed for the random number generator.
+               major_threshold: Fraction of the nodes above which an outbreak
+                   is major, in (0, 1].
+
+            Returns:
+               A tuple (probability of a major outbreak, histogram of the final
+               number of recovered nodes of the small outbreaks).
+            )pbdoc", py::arg("sample"), py::arg("seed"),
+            py::arg("major_threshold") = 0.01)
+
+        .def("save", (void (SpreadingProcess::*)(const string&) const)
+            &SpreadingProcess::save, R"pbdoc(
+            Save the complete process (parameters, network and dynamical state,
+            including the random number generator) to a binary file. A process
+            loaded from it continues exactly as the original one would.
+
+            Args:
+               path: Path to the file.
+            )pbdoc", py::arg("path"))
+
+        .def_static("load", (SpreadingProcess (*)(const string&))
+            &SpreadingProcess::load, R"pbdoc(
+            Load a process saved with save.
+
+            Args:
+               path: Path to the file.
+            )pbdoc", py::arg("path"))
+
+        .def("clone", &SpreadingProcess::clone, R"pbdoc(
+            Returns an exact copy of the process, sharing the network
+            structure.
+            )pbdoc")
+
+        .def("fork", &SpreadingProcess::fork, R"pbdoc(
+            Returns a copy of the current state of the process, sharing the
+            network structure, with a new seed for the random number
+            generator. The seed also selects the stream of the generator, so
+            copies with different seeds draw from distinct sequences. The
+            trajectory of the copy starts at the current state.
+
+            Args:
+               seed: Integer seed for the random number generator of the copy.
+            )pbdoc", py::arg("seed"))
+
+        .def("__copy__", &SpreadingProcess::clone)
+
+        .def("__deepcopy__", [](const SpreadingProcess& sp, py::dict memo)
+            {return sp.clone();}, py::arg("memo"))
+
+        .def(py::pickle(
+            [](const SpreadingProcess& sp)
+            {
+                ostringstream out;
+                sp.save(out);
+                return py::bytes(out.str());
+            },
+            [](py::bytes data)
+            {
+                istringstream in(static_cast<string>(data));
+                return SpreadingProcess::load(in);
+            }));
+
+    /* =====================================
+     * Random networks
+     * =====================================*/
+
+    m.def("erdos_renyi_network", [](size_t size, double probability,
+                unsigned int seed, unsigned int thread_number)
+        {
+            py::gil_scoped_release release;
+            return erdos_renyi_network(size, probability, seed,
+                    thread_number);
+        }, R"pbdoc(
+        Erdos-Renyi network G(N,p), drawn by geometric skipping over the pairs
+        of nodes in a time proportional to the number of edges.
+
+        The network only depends on the seed, not on the number of threads.
+
+        Args:
+           size: Number of nodes.
+           probability: Probability of each edge.
+           seed: Integer seed for the random number generators.
+           thread_number: Number of threads (0 for all available).
+        )pbdoc", py::arg("size"), py::arg("probability"), py::arg("seed"),
+        py::arg("thread_number") = 1);
+
+    m.def("configuration_model_network", [](
+                const vector<size_t>& degree_sequence, unsigned int seed,
+                unsigned int thread_number)
+        {
+            py::gil_scoped_release release;
+            return configuration_model_network(degree_sequence, seed,
+                    thread_number);
+        }, R"pbdoc(
+        Network of the configuration model, matching the stubs uniformly at
+        random. Self-loops and multiple edges are kept.
+
+        Args:
+           degree_sequence: Degree of each node, of even sum.
+           seed: Integer seed for the random number generator.
+           thread_number: Number of threads (0 for all available).
+        )pbdoc", py::arg("degree_sequence"), py::arg("seed"),
+        py::arg("thread_number") = 1);
+
+    m.def("chung_lu_network", [](const vector<double>& weight_vector,
+                unsigned int seed, unsigned int thread_number)
+        {
+            py::gil_scoped_release release;
+            return chung_lu_network(weight_vector, seed, thread_number);
+        }, R"pbdoc(
+        Chung-Lu network, where nodes i and j are joined with probability
+        min(w_i w_j/sum(w), 1), in a time proportional to the number of edges.
+
+        The network only depends on the seed, not on the number of threads.
+
+        Args:
+           weight_list: Expected degree of each node.
+           seed: Integer seed for the random number generators.
+           thread_number: Number of threads (0 for all available).
+        )pbdoc", py::arg("weight_list"), py::arg("seed"),
+        py::arg("thread_number") = 1);
+
+    m.def("barabasi_albert_network", [](size_t size, size_t edge_number,
+                unsigned int seed, unsigned int thread_number)
+        {
+            py::gil_scoped_release release;
+            return barabasi_albert_network(size, edge_number, seed,
+                    thread_number);
+        }, R"pbdoc(
+        Barabasi-Albert network grown by linear preferential attachment, each
+        new node being joined to edge_number distinct nodes.
+
+        Args:
+           size: Number of nodes.
+           edge_number: Number of edges of each new node.
+           seed: Integer seed for the random number generator.
+           thread_number: Number of threads (0 for all available).
+        )pbdoc", py::arg("size"), py::arg("edge_number"), py::arg("seed"),
+        py::arg("thread_number") = 1);
+
+    /* =====================================
+     * Input/output
+     * =====================================*/
+
+    m.def("load_edge_list", [](const string& path, unsigned int thread_number)
+        {
+            py::gil_scoped_release release;
+            return load_edge_list(path, thread_number);
+        }, R"pbdoc(
+        Read a network from a text file with one edge per line. The nodes are
+        two non-negative integers separated by spaces, tabs or a comma; the
+        rest of the line is ignored, as well as blank lines and lines
+        starting with '#' or '%'. The file is mapped in memory and parsed on
+        multiple threads, without building an edge list. The neighbors of
+        each node are sorted, whatever the number of threads.
+
+        Args:
+           path: Path to the file.
+           thread_number: Number of threads (0 for all available).
+
+        Returns:
+           A Network.
+        )pbdoc", py::arg("path"), py::arg("thread_number") = 0);
+
+    m.def("load_labeled_edge_list", [](const string& path, size_t size,
+                unsigned int thread_number)
+        {
+            vector<uint64_t> identifier_vector;
+            Network network = [&]()
+            {
+                py::gil_scoped_release release;
+                return load_labeled_edge_list(path, identifier_vector, size,
+                        thread_number);
+            }();
+            return py::make_tuple(network,
+                    array_move(move(identifier_vector)));
+        }, R"pbdoc(
+        Read a simple network from a text edge list with arbitrary node
+        identifiers (non-negative integers below 2**64), in the format of
+        load_edge_list. The identifiers are relabeled from 0 in increasing
+        order; self-loops and duplicated edges are removed.
+
+        Args:
+           path: Path to the file.
+           size: Number of nodes, to add isolated nodes after the ones of the
+               edge list (0 for the number of identifiers).
+           thread_number: Number of threads (0 for all available).
+
+        Returns:
+           A tuple (network, identifiers), identifiers[i] being the
+           identifier of node i.
+        )pbdoc", py::arg("path"), py::arg("size") = 0,
+        py::arg("thread_number") = 0);
+
+    m.def("relabeled_network", [](
+                const vector<pair<uint64_t, uint64_t> >& edge_list,
+                size_t size, unsigned int thread_number)
+        {
+            vector<uint64_t> identifier_vector;
+            Network network = [&]()
+            {
+                py::gil_scoped_release release;
+                return relabeled_network(edge_list, identifier_vector, size,
+                        thread_number);
+            }();
+            return py::make_tuple(network,
+                    array_move(move(identifier_vector)));
+        }, R"pbdoc(
+        Simple network from an edge list with arbitrary node identifiers, as
+        load_labeled_edge_list.
+
+        Args:
+           edge_list: Edge list with node identifiers.
+           size: Number of nodes, to add isolated nodes after the ones of the
+               edge list (0 for the number of identifiers).
+           thread_number: Number of threads (0 for all available).
+
+        Returns:
+           A tuple (network, identifiers), identifiers[i] being the
+           identifier of node i.
+        )pbdoc", py::arg("edge_list"), py::arg("size") = 0,
+        py::arg("thread_number") = 1);
+
+    m.def("simple_network", [](const Network& network, size_t size,
+                unsigned int thread_number)
+        {
+            py::gil_scoped_release release;
+            return simple_network(network, size, thread_number);
+        }, R"pbdoc(
+        Returns a copy of a network without self-loops and duplicated edges,
+        the neighbors of each node being sorted.
+
+        Args:
+           network: Network.
+           size: Number of nodes, to add isolated nodes after the ones of the
+               network (0 for the size of the network).
+           thread_number: Number of threads (0 for all available).
+        )pbdoc", py::arg("network"), py::arg("size") = 0,
+        py::arg("thread_number") = 1);
+
+    m.def("output_network_file", [](const string& path,
+                const Network& network, bool degree_sorted)
+        {
+            py::gil_scoped_release release;
+            output_network_file(path, network, degree_sorted);
+        }, R"pbdoc(
+        Write a network to a binary file, to be mapped in memory by
+        input_network_file instead of parsing an edge list at every run.
+
+        Args:
+           path: Path to the file.
+           network: Network, or edge list of the network.
+           degree_sorted: If True, the nodes are relabeled by decreasing
+               degree; the original labels are given by
+               input_network_permutation.
+        )pbdoc", py::arg("path"), py::arg("network"),
+        py::arg("degree_sorted") = false);
+
+    m.def("output_network_file", [](const string& path,
+                vector<pair<NodeLabel, NodeLabel> >& edge_list,
+                bool degree_sorted)
+        {
+            py::gil_scoped_release release;
+            output_network_file(path, Network(edge_list), degree_sorted);
+        }, py::arg("path"), py::arg("edge_list"),
+        py::arg("degree_sorted") = false);
+
+    m.def("input_network_file", &input_network_file, R"pbdoc(
+        Map a file written by output_network_file in memory. Nothing is
+        parsed nor copied: the network is used in place, read-only, and the
+        pages are shared by all the processes mapping the same file.
+
+        Args:
+           path: Path to the file.
+           verify: If True, check the offsets and the neighbors in one pass
+               over the file, so that a corrupted file raises an error. Only
+               turn it off for trusted files.
+
+        Returns:
+           A Network.
+        )pbdoc", py::arg("path"), py::arg("verify") = true);
+
+    m.def("input_network_permutation", [](const string& path)
+        {return array_move(input_network_permutation(path));}, R"pbdoc(
+        Returns the original label of each node of a file written with
+        degree_sorted=True, or an empty array.
+
+        Args:
+           path: Path to the file.
+        )pbdoc", py::arg("path"));
+
+    m.def("read_transmission_tree", [](const string& path)
+        {
+            vector<double> time_vector;
+            vector<NodeLabel> source_vector;
+            vector<NodeLabel> node_vector;
+            input_transmission_tree(path, time_vector, source_vector,
+                    node_vector);
+            return py::make_tuple(array_move(move(time_vector)),
+                    array_move(move(source_vector)),
+                    array_move(move(node_vector)));
+        }, R"pbdoc(
+        Read a file written with SpreadingProcess.set_transmission_output.
+
+        Args:
+           path: Path to the file.
+
+        Returns:
+           A tuple of arrays (time, infecting node, infected node), with one
+           entry per infection event.
+        )pbdoc", py::arg("path"));
+
+    /* =====================================
+     * Parameter sweeps
+     * =====================================*/
+
+    m.def("rate_sweep", [](const SpreadingProcess& sp,
+                const vector<RateTuple>& rate_vector,
+                const vector<NodeLabel>& Inode_vector, unsigned int replicate,
+                unsigned int seed, double time_variation,
+                unsigned int thread_number)
+        {
+            SweepResult result;
+            {
+                py::gil_scoped_release release;
+                result = rate_sweep(sp, rate_vector, Inode_vector, replicate,
+                        seed, time_variation, thread_number);
+            }
+            py::object shape = py::make_tuple(rate_vector.size(), replicate);
+            return py::make_tuple(
+                    array_move(move(result.prevalence_vector))
+                        .attr("reshape")(shape),
+                    array_move(move(result.final_size_vector))
+                        .attr("reshape")(shape));
+        }, R"pbdoc(
+        Simulate replicates of a process for a list of rates. The network and
+        the propensity groups are built once per thread and reused for every
+        rate with set_rates, instead of building a new process per rate.
+
+        Replicate j of rate i uses the seed seed + i*replicate + j, so that
+        the results do not depend on the number of threads.
+
+        Args:
+           process: Prototype SpreadingProcess; its state is not used.
+           rate_list: List of tuples (transmission_rate, recovery_rate,
+               waning_immunity_rate).
+           Inode_vector: List of nodes infected at the start of each
+               replicate.
+           replicate: Number of replicates per rate.
+           seed: Integer seed of the first replicate.
+           time_variation: Duration of each replicate.
+           thread_number: Number of threads (0 for all available).
+
+        Returns:
+           A tuple of arrays of shape (len(rate_list), replicate): prevalence
+           and fraction of recovered nodes at the end of each replicate.
+        )pbdoc", py::arg("process"), py::arg("rate_list"),
+        py::arg("Inode_vector"), py::arg("replicate"), py::arg("seed"),
+        py::arg("time_variation") = numeric_limits<double>::infinity(),
+        py::arg("thread_number") = 1);
+
+    /* =====================================
+     * Bond percolation
+     * =====================================*/
+
+    m.def("transmissibility", &transmissibility, R"pbdoc(
+        Returns the transmissibility transmission_rate/(transmission_rate +
+        recovery_rate) of an edge for the SIR model.
+        )pbdoc", py::arg("transmission_rate"), py::arg("recovery_rate"));
+
+    m.def("bond_percolation", [](vector<pair<NodeLabel, NodeLabel> >& edge_list,
+                const vector<double>& transmissibility_vector,
+                unsigned int replicate, unsigned int seed,
+                unsigned int thread_number)
+        {
+            PercolationEstimate estimate;
+            {
+                py::gil_scoped_release release;
+                estimate = bond_percolation(Network(edge_list),
+                        transmissibility_vector, replicate, seed,
+                        thread_number);
+            }
+            return py::make_tuple(
+                    array_move(move(estimate.mean_final_size_vector)),
+                    array_move(move(estimate.final_size_std_vector)),
+                    array_move(move(estimate.largest_component_vector)));
+        }, R"pbdoc(
+        SIR final size statistics for a list of transmissibilities, from a
+        bond percolation on the network. Each replicate occupies the edges in
+        a random order and merges the clusters with a union-find structure
+        (Newman-Ziff); all transmissibilities are obtained from the same pass
+        by binomial averaging.
+
+        The mapping is exact for a fixed infectious period. For the SIR model
+        with exponential recovery, use transmissibility(transmission_rate,
+        recovery_rate): the size of large outbreaks is recovered, while the
+        distribution of small outbreaks is only approximate.
+
+        Args:
+           edge_list: Edge list of the network.
+           transmissibility_list: Occupation probabilities of the edges.
+           replicate: Number of random edge orders.
+           seed: Integer seed for the random number generators.
+           thread_number: Number of threads (0 for all available).
+
+        Returns:
+           A tuple of arrays (mean final size from a random seed, standard
+           deviation of the final size, largest component size), as
+           fractions of the nodes.
+        )pbdoc", py::arg("edge_list"), py::arg("transmissibility_list"),
+        py::arg("replicate"), py::arg("seed"), py::arg("thread_number") = 1);
+
+    m.def("bond_percolation", [](const Network& network,
+                const vector<double>& transmissibility_vector,
+                unsigned int replicate, unsigned int seed,
+                unsigned int thread_number)
+        {
+            PercolationEstimate estimate;
+            {
+                py::gil_scoped_release release;
+                estimate = bond_percolation(network, transmissibility_vector,
+                        replicate, seed, thread_number);
+            }
+            return py::make_tuple(
+                    array_move(move(estimate.mean_final_size_vector)),
+                    array_move(move(estimate.final_size_std_vector)),
+                    array_move(move(estimate.largest_component_vector)));
+        }, R"pbdoc(
+        Same as above, for a Network.
+        )pbdoc", py::arg("network"), py::arg("transmissibility_list"),
+        py::arg("replicate"), py::arg("seed"), py::arg("thread_number") = 1);
+
+    /* =====================================
+     * Rare-event sampling
+     * =====================================*/
+
+    m.def("multilevel_splitting", [](const SpreadingProcess& sp,
+                const vector<size_t>& level_vector,
+                unsigned int population_size, unsigned int replicate,
+                unsigned int seed, unsigned int thread_number, bool cumulative,
+                double max_time)
+        {
+            SplittingEstimate estimate;
+            {
+                py::gil_scoped_release release;
+                estimate = multilevel_splitting(sp, level_vector,
+                        population_size, replicate, seed, thread_number,
+                        cumulative, max_time);
+            }
+            return py::make_tuple(estimate.probability, estimate.variance,
+                    array_move(move(estimate.level_probability_vector)),
+                    array_move(move(estimate.estimate_vector)));
+        }, R"pbdoc(
+        Estimate the probability that the number of infected nodes (or of
+        infected and recovered nodes if cumulative) reaches the last level
+        before absorption, starting from the current state of a process, using
+        fixed-effort multilevel splitting.
+
+        At each level, a population of trajectories (forks of the process) is
+        evolved until it reaches the level or dies out. The fraction of
+        survivors estimates the conditional probability of the level, then the
+        population is regenerated from uniformly chosen survivors. The product
+        of the fractions is an unbiased estimate.
+
+        Args:
+           process: Initialized SpreadingProcess, left unchanged.
+           level_vector: Increasing list of levels.
+           population_size: Number of trajectories per level.
+           replicate: Number of independent estimates, used for the variance.
+           seed: Integer seed for the random number generators.
+           thread_number: Number of threads (0 for all available).
+           cumulative: If true, levels on the number of infected and recovered
+               nodes.
+           max_time: Trajectories not reaching the last level within this time
+               are discarded.
+
+        Returns:
+           A tuple (probability, variance of the estimate, mean conditional
+           probability of each level, estimate of each replicate).
+        )pbdoc", py::arg("process"), py::arg("level_vector"),
+        py::arg("population_size"), py::arg("replicate"), py::arg("seed"),
+        py::arg("thread_number") = 1, py::arg("cumulative") = false,
+        py::arg("max_time") = numeric_limits<double>::infinity());
 
     /* =====================================
      * Class deriving from SpreadingProcess
@@ -195,16 +1253,48 @@ PYBIND11_MODULE(spreading_CR, m)
             py::arg("base") = 2, py::arg("update_history_rate") = 0.1,
             py::arg("history_vector_size") = 100)
 
+        .def(py::init<const Network&, double, double, double, double, double,
+                unsigned int>(), R"pbdoc(
+            Constructor from a Network, shared with the process without copy.
+            )pbdoc", py::arg("network"), py::arg("transmission_rate"),
+            py::arg("recovery_rate"), py::arg("waning_immunity_rate"),
+            py::arg("base") = 2, py::arg("update_history_rate") = 0.1,
+            py::arg("history_vector_size") = 100)
+
+        .def("set_transmission_output",
+            &QSSpreadingProcess::set_transmission_output, R"pbdoc(
+            Not available for the quasistationary process.
+            )pbdoc", py::arg("path"), py::arg("batch_size") = 1 << 20)
+
+        .def("set_infection_recording",
+            &QSSpreadingProcess::set_infection_recording, R"pbdoc(
+            Not available for the quasistationary process.
+            )pbdoc", py::arg("recording"))
+
         .def("initialize_random", &QSSpreadingProcess::initialize_random, R"pbdoc(
-            Initialize the spreading process with randomly infected nodes.
+            Initialize the spreading process with randomly infected nodes, drawn
+            without replacement among the susceptible nodes.
 
             Args:
                fraction: Initial fraction of infected nodes.
                seed: Integer seed for the random number generator.
             )pbdoc", py::arg("fraction"), py::arg("seed"))
 
+        .def("initialize_mask", [](QSSpreadingProcess& sp,
+                BoolArray mask, unsigned int seed)
+            {sp.initialize(mask_node_vector(mask, sp.get_size()), seed);},
+            R"pbdoc(
+            Initialize the spreading process with the infected nodes given by a
+            boolean mask.
+
+            Args:
+               mask: Boolean array with one entry per node, True for the
+                   initially infected nodes.
+               seed: Integer seed for the random number generator.
+            )pbdoc", py::arg("mask"), py::arg("seed"))
+
         .def("initialize", (void (QSSpreadingProcess::*)(const vector<NodeLabel>&,
-            unsigned int)) &SpreadingProcess::initialize, R"pbdoc(
+            unsigned int)) &QSSpreadingProcess::initialize, R"pbdoc(
             Initialize the spreading process.
 
             Args:
@@ -213,7 +1303,7 @@ PYBIND11_MODULE(spreading_CR, m)
             )pbdoc", py::arg("Inode_vector"), py::arg("seed"))
 
         .def("initialize", (void (QSSpreadingProcess::*)(const vector<NodeLabel>&,
-            const vector<NodeLabel>&,unsigned int)) &SpreadingProcess::initialize,              R"pbdoc(
+            const vector<NodeLabel>&,unsigned int)) &QSSpreadingProcess::initialize,              R"pbdoc(
             Initialize the spreading process.
 
             Args:
@@ -224,7 +1314,7 @@ PYBIND11_MODULE(spreading_CR, m)
                 py::arg("seed"))
 
         .def("initialize", (void (QSSpreadingProcess::*)(const vector<NodeLabel>&)
-                    ) &SpreadingProcess::initialize, R"pbdoc(
+                    ) &QSSpreadingProcess::initialize, R"pbdoc(
             Initialize the spreading process.
 
             Args:
@@ -232,7 +1322,7 @@ PYBIND11_MODULE(spreading_CR, m)
             )pbdoc", py::arg("Inode_vector"))
 
         .def("initialize", (void (QSSpreadingProcess::*)(const vector<NodeLabel>&,
-            const vector<NodeLabel>&)) &SpreadingProcess::initialize, R"pbdoc(
+            const vector<NodeLabel>&)) &QSSpreadingProcess::initialize, R"pbdoc(
             Initialize the spreading process.
 
             Args:
@@ -246,6 +1336,45 @@ PYBIND11_MODULE(spreading_CR, m)
             Set a new value for the update history rate.
             )pbdoc")
 
+        .def("set_relaxation_time", &QSSpreadingProcess::set_relaxation_time,
+                R"pbdoc(
+            Set the time, measured from the initialization, before which the
+            quasistationary statistics are not accumulated.
+
+            Args:
+               relaxation_time: Relaxation time.
+            )pbdoc", py::arg("relaxation_time"))
+
+        .def("get_relaxation_time", &QSSpreadingProcess::get_relaxation_time,
+                R"pbdoc(
+            Returns the relaxation time.
+            )pbdoc")
+
+        .def("reset_statistics", &QSSpreadingProcess::reset_statistics,
+                R"pbdoc(
+            Discard the accumulated quasistationary statistics.
+            )pbdoc")
+
+        .def("get_qs_estimate", [](const QSSpreadingProcess& sp)
+            {
+                QSEstimate estimate = sp.get_qs_estimate();
+                return py::make_tuple(
+                        array_move(move(estimate.distribution)),
+                        estimate.mean_prevalence, estimate.susceptibility,
+                        estimate.lifespan);
+            }, R"pbdoc(
+            Quasistationary estimates accumulated during evolve, weighted by
+            the time spent in each state after the relaxation time.
+
+            Returns:
+               A tuple (distribution, mean prevalence, susceptibility, mean
+               lifespan). The distribution is an array with the fraction of
+               time spent with n infected nodes; the susceptibility is
+               N(<rho^2> - <rho>^2)/<rho>, whose peak locates the epidemic
+               threshold in the QS method, and the mean lifespan is the
+               observation time per absorption (inf without absorption).
+            )pbdoc")
+
         .def("reset", &QSSpreadingProcess::reset, R"pbdoc(
             Reset the spreading process. It needs to be initialized again.
             )pbdoc")
@@ -255,5 +1384,99 @@ PYBIND11_MODULE(spreading_CR, m)
 
             Args:
                time_variation: Time duration for the simulation.
-            )pbdoc", py::arg("time_variation"));
+            )pbdoc", py::arg("time_variation"))
+
+        .def("evolve_until", [](QSSpreadingProcess& sp, py::args args,
+                py::kwargs kwargs)
+            {return sp.evolve_until(StopCondition());}, R"pbdoc(
+            Not available for the quasistationary process.
+            )pbdoc")
+
+        .def("save", (void (QSSpreadingProcess::*)(const string&) const)
+            &QSSpreadingProcess::save, R"pbdoc(
+            Save the complete process (parameters, network, dynamical state
+            and history) to a binary file.
+
+            Args:
+               path: Path to the file.
+            )pbdoc", py::arg("path"))
+
+        .def_static("load", (QSSpreadingProcess (*)(const string&))
+            &QSSpreadingProcess::load, R"pbdoc(
+            Load a process saved with save.
+
+            Args:
+               path: Path to the file.
+            )pbdoc", py::arg("path"))
+
+        .def("clone", &QSSpreadingProcess::clone, R"pbdoc(
+            Returns an exact copy of the process, sharing the network
+            structure.
+            )pbdoc")
+
+        .def("fork", &QSSpreadingProcess::fork, R"pbdoc(
+            Returns a copy of the current state and history of the process,
+            sharing the network structure, with a new seed for the random
+            number generator. The seed also selects the stream of the
+            generator, so copies with different seeds draw from distinct
+            sequences.
+
+            Args:
+               seed: Integer seed for the random number generator of the copy.
+            )pbdoc", py::arg("seed"))
+
+        .def("__copy__", &QSSpreadingProcess::clone)
+
+        .def("__deepcopy__", [](const QSSpreadingProcess& sp, py::dict memo)
+            {return sp.clone();}, py::arg("memo"))
+
+        .def(py::pickle(
+            [](const QSSpreadingProcess& sp)
+            {
+                ostringstream out;
+                sp.save(out);
+                return py::bytes(out.str());
+            },
+            [](py::bytes data)
+            {
+                istringstream in(static_cast<string>(data));
+                return QSSpreadingProcess::load(in);
+            }));
+
+    m.def("qs_replicates", [](const QSSpreadingProcess& sp,
+                unsigned int replicate, unsigned int seed,
+                double time_variation, unsigned int thread_number)
+        {
+            QSReplicateResult result;
+            {
+                py::gil_scoped_release release;
+                result = qs_replicates(sp, replicate, seed, time_variation,
+                        thread_number);
+            }
+            return py::make_tuple(
+                    array_move(move(result.estimate.distribution)),
+                    result.estimate.mean_prevalence,
+                    result.estimate.susceptibility, result.estimate.lifespan,
+                    array_move(move(result.mean_prevalence_vector)));
+        }, R"pbdoc(
+        Evolve independent replicates of a quasistationary process on
+        multiple threads and merge their statistics. Each replicate is a fork
+        of the process, sharing its network, with its own history and the
+        seed seed + j for replicate j. The relaxation time of the process
+        applies, measured from its initialization.
+
+        Args:
+           process: Initialized QSSpreadingProcess; it is not modified.
+           replicate: Number of replicates.
+           seed: Integer seed of the first replicate.
+           time_variation: Duration of each replicate.
+           thread_number: Number of threads (0 for all available).
+
+        Returns:
+           A tuple (distribution, mean prevalence, susceptibility, mean
+           lifespan, mean prevalence of each replicate), the first four
+           computed from the merged occupation times as in get_qs_estimate;
+           the susceptibility is N(<rho^2> - <rho>^2)/<rho>.
+        )pbdoc", py::arg("process"), py::arg("replicate"), py::arg("seed"),
+        py::arg("time_variation"), py::arg("thread_number") = 1);
 }
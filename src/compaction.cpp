@@ -0,0 +1,270 @@
+/**
+* \file compaction.cpp
+* \brief Functions for the relabeling and simplification of networks
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#include <compaction.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace net
+{//start of namespace net
+
+/**
+ * \brief Split the nodes in blocks with about the same number of neighbors
+ * \param[in] offset offsets of the network
+ * \param[in] size number of nodes
+ * \param[in] block_number number of blocks
+ * \return first node of each block, followed by the number of nodes
+ */
+static vector<size_t> node_block_vector(const uint64_t* offset, size_t size,
+        size_t block_number)
+{
+    vector<size_t> block_vector(block_number+1, size);
+    block_vector[0] = 0;
+    for (size_t block = 1; block < block_number; block++)
+    {
+        block_vector[block] = upper_bound(offset + 1, offset + size + 1,
+            offset[size]*block/block_number) - offset - 1;
+    }
+    return block_vector;
+}
+
+/**
+ * \brief Position of an identifier in an open addressing table (Fibonacci
+ *  hashing, then linear probing)
+ * \param[in] identifier identifier
+ * \param[in] shift 64 minus the logarithm of the size of the table
+ */
+static size_t hash_position(uint64_t identifier, unsigned int shift)
+{
+    return (identifier*0x9E3779B97F4A7C15ull) >> shift;
+}
+
+/**
+ * \brief Simple version of a network: the self-loops and the duplicated
+ *  edges are removed, and the neighbors of each node are sorted. The nodes
+ *  are processed by blocks on multiple threads.
+ * \param[in] network network
+ * \param[in] size number of nodes, at least the size of the network, so that
+ *  isolated nodes can be added at the end (0: size of the network)
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ */
+Network simple_network(const Network& network, size_t size,
+        unsigned int thread_number)
+{
+    if (thread_number == 0)
+    {
+        thread_number = max(thread::hardware_concurrency(), 1u);
+    }
+    size_t n = network.size();
+    size_t N = (size == 0) ? n : size;
+    if (N < n)
+    {
+        throw invalid_argument("The size is smaller than the network");
+    }
+    if (N > size_t(numeric_limits<NodeLabel>::max()))
+    {
+        throw overflow_error("Too many nodes for the node label type");
+    }
+    const uint64_t* offset = network.get_offset_data();
+    vector<NodeLabel> buffer_vector(network.get_neighbor_data(),
+        network.get_neighbor_data() + network.get_neighbor_number());
+    size_t block_number = min(size_t(16)*thread_number, max(n, size_t(1)));
+    vector<size_t> block_vector = node_block_vector(offset, n, block_number);
+
+    //distinct neighbors at the start of each neighbor vector, and degrees
+    vector<uint64_t> offset_vector(N+1, 0);
+    parallel_for(block_number, thread_number, [&](size_t block)
+    {
+        for (size_t node = block_vector[block]; node < block_vector[block+1];
+            node++)
+        {
+            auto first = buffer_vector.begin() + offset[node];
+            auto last = buffer_vector.begin() + offset[node+1];
+            sort(first, last);
+            last = unique(first, last);
+            last = remove(first, last, node);
+            offset_vector[node+1] = last - first;
+        }
+    });
+    for (size_t node = 0; node < N; node++)
+    {
+        offset_vector[node+1] += offset_vector[node];
+    }
+
+    vector<NodeLabel> neighbor_vector(offset_vector[N]);
+    parallel_for(block_number, thread_number, [&](size_t block)
+    {
+        for (size_t node = block_vector[block]; node < block_vector[block+1];
+            node++)
+        {
+            copy(buffer_vector.begin() + offset[node],
+                buffer_vector.begin() + offset[node]
+                + (offset_vector[node+1] - offset_vector[node]),
+                neighbor_vector.begin() + offset_vector[node]);
+        }
+    });
+    return Network(move(offset_vector), move(neighbor_vector));
+}
+
+/**
+ * \brief Simple network from an edge list with arbitrary node identifiers.
+ *  The identifiers are sorted and made unique on multiple threads (each
+ *  block is sorted, then the blocks are merged pairwise), and node i of the
+ *  network is the i-th smallest identifier. The self-loops and the
+ *  duplicated edges are removed.
+ * \param[in] edge_list_vector blocks of the edge list
+ * \param[out] identifier_vector identifier of each node with an edge
+ * \param[in] size number of nodes, so that isolated nodes can be added after
+ *  the identified ones (0: number of identifiers)
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ */
+Network relabeled_network(const IdentifierEdgeBlockVector& edge_list_vector,
+        vector<uint64_t>& identifier_vector, size_t size,
+        unsigned int thread_number)
+{
+    if (thread_number == 0)
+    {
+        thread_number = max(thread::hardware_concurrency(), 1u);
+    }
+    size_t block_number = edge_list_vector.size();
+    vector<vector<uint64_t> > identifier_block_vector(block_number);
+    parallel_for(block_number, thread_number, [&](size_t block)
+    {
+        vector<uint64_t>& identifier_block = identifier_block_vector[block];
+        identifier_block.reserve(2*edge_list_vector[block].size());
+        for (const auto& edge : edge_list_vector[block])
+        {
+            identifier_block.push_back(edge.first);
+            identifier_block.push_back(edge.second);
+        }
+        sort(identifier_block.begin(), identifier_block.end());
+        identifier_block.erase(unique(identifier_block.begin(),
+            identifier_block.end()), identifier_block.end());
+    });
+    for (size_t width = 1; width < block_number; width *= 2)
+    {
+        parallel_for((block_number + 2*width - 1)/(2*width), thread_number,
+            [&](size_t pair_index)
+        {
+            size_t first = 2*width*pair_index;
+            size_t second = first + width;
+            if (second >= block_number)
+            {
+                return;
+            }
+            vector<uint64_t> merged_block;
+            merged_block.reserve(identifier_block_vector[first].size()
+                + identifier_block_vector[second].size());
+            set_union(identifier_block_vector[first].begin(),
+                identifier_block_vector[first].end(),
+                identifier_block_vector[second].begin(),
+                identifier_block_vector[second].end(),
+                back_inserter(merged_block));
+            identifier_block_vector[first].swap(merged_block);
+            vector<uint64_t>().swap(identifier_block_vector[second]);
+        });
+    }
+    identifier_vector.clear();
+    if (block_number > 0)
+    {
+        identifier_vector.swap(identifier_block_vector[0]);
+    }
+    size_t N = (size == 0) ? identifier_vector.size() : size;
+    if (N < identifier_vector.size())
+    {
+        throw invalid_argument("The size is smaller than the number of nodes");
+    }
+    if (N > size_t(numeric_limits<NodeLabel>::max()))
+    {
+        throw overflow_error("Too many nodes for the node label type");
+    }
+
+    //label of each identifier, in a table at most half full; a binary
+    //search in the sorted identifiers would miss the cache at every step
+    unsigned int shift = 63;
+    while ((size_t(1) << (64 - shift)) < 2*identifier_vector.size())
+    {
+        shift--;
+    }
+    const NodeLabel EMPTY = numeric_limits<NodeLabel>::max();
+    size_t mask = (size_t(1) << (64 - shift)) - 1;
+    vector<pair<uint64_t, NodeLabel> > table_vector(mask + 1,
+        make_pair(uint64_t(0), EMPTY));
+    for (size_t label = 0; label < identifier_vector.size(); label++)
+    {
+        size_t position = hash_position(identifier_vector[label], shift);
+        while (table_vector[position].second != EMPTY)
+        {
+            position = (position + 1) & mask;
+        }
+        table_vector[position] = make_pair(identifier_vector[label],
+            NodeLabel(label));
+    }
+    auto label_of = [&](uint64_t identifier)
+    {
+        size_t position = hash_position(identifier, shift);
+        while (table_vector[position].first != identifier)
+        {
+            position = (position + 1) & mask;
+        }
+        return table_vector[position].second;
+    };
+
+    vector<vector<pair<NodeLabel, NodeLabel> > > label_edge_list_vector(
+        block_number);
+    parallel_for(block_number, thread_number, [&](size_t block)
+    {
+        auto& edge_list = label_edge_list_vector[block];
+        edge_list.reserve(edge_list_vector[block].size());
+        for (const auto& edge : edge_list_vector[block])
+        {
+            edge_list.emplace_back(label_of(edge.first),
+                label_of(edge.second));
+        }
+    });
+    vector<pair<uint64_t, NodeLabel> >().swap(table_vector);
+    return simple_network(Network(label_edge_list_vector, N, thread_number),
+        N, thread_number);
+}
+
+/**
+ * \brief Simple network from an edge list with arbitrary node identifiers
+ * \param[in] edge_list edge list
+ * \param[out] identifier_vector identifier of each node with an edge
+ * \param[in] size number of nodes, so that isolated nodes can be added after
+ *  the identified ones (0: number of identifiers)
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ */
+Network relabeled_network(const vector<pair<uint64_t, uint64_t> >& edge_list,
+        vector<uint64_t>& identifier_vector, size_t size,
+        unsigned int thread_number)
+{
+    if (thread_number == 0)
+    {
+        thread_number = max(thread::hardware_concurrency(), 1u);
+    }
+    size_t block_number = max(min(size_t(4)*thread_number, edge_list.size()),
+        size_t(1));
+    IdentifierEdgeBlockVector edge_list_vector(block_number);
+    parallel_for(block_number, thread_number, [&](size_t block)
+    {
+        edge_list_vector[block].assign(
+            edge_list.begin() + edge_list.size()*block/block_number,
+            edge_list.begin() + edge_list.size()*(block+1)/block_number);
+    });
+    return relabeled_network(edge_list_vector, identifier_vector, size,
+        thread_number);
+}
+
+}//end of namespace net
@@ -0,0 +1,37 @@
+/**
+* \file compaction.hpp
+* \brief Header file for the relabeling and simplification of networks
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#ifndef COMPACTION_HPP_
+#define COMPACTION_HPP_
+
+#include <Network.hpp>
+#include <vector>
+#include <cstdint>
+
+namespace net
+{//start of namespace net
+
+//Edge list with arbitrary node identifiers, split in blocks
+typedef std::vector<std::vector<std::pair<uint64_t, uint64_t> > >
+    IdentifierEdgeBlockVector;
+
+Network simple_network(const Network& network, std::size_t size = 0,
+        unsigned int thread_number = 1);
+
+Network relabeled_network(const IdentifierEdgeBlockVector& edge_list_vector,
+        std::vector<uint64_t>& identifier_vector, std::size_t size = 0,
+        unsigned int thread_number = 1);
+
+Network relabeled_network(
+        const std::vector<std::pair<uint64_t, uint64_t> >& edge_list,
+        std::vector<uint64_t>& identifier_vector, std::size_t size = 0,
+        unsigned int thread_number = 1);
+
+}//end of namespace net
+
+#endif /* COMPACTION_HPP_ */
@@ -9,6 +9,9 @@
 #include <evolution.hpp>
 #include <utility>
 #include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
 
 using namespace std;
 
@@ -22,34 +25,101 @@ uint32_t INDEX_MAP(uint32_t NUM)
 }
 
 /**
- * \brief Infect a fraction of the nodes
+ * \brief Table of -log(u) at the center of TABLE_SIZE bins of [0,1), used to
+ *  draw exponential variates. It is computed once and shared by all processes.
+ */
+const double* get_log_table()
+{
+    static const vector<double> log_table = []()
+    {
+        vector<double> table(TABLE_SIZE);
+        for (uint32_t i = 0; i < TABLE_SIZE; i++)
+        {
+            table[i] = -log((i+0.5)/TABLE_SIZE);
+        }
+        return table;
+    }();
+    return log_table.data();
+}
+
+/**
+ * \brief Infect a fraction of the nodes, chosen uniformly among the
+ *  susceptible nodes. The labels 0,...,N-1 are drawn without replacement by
+ *  a partial Fisher-Yates shuffle and the non-susceptible ones are skipped,
+ *  so the nodes only depend on the state and the generator, not on the
+ *  order of the node vectors. The shuffled labels are kept in a hash map,
+ *  or in a vector when a large fraction of the labels is drawn.
  * \param[in] net a reference to an object StaticNetworkSIR
  * \param[in] fraction a double representing the fraction to infect
  */
 void infect_fraction(StaticNetworkSIR& net, double fraction, RNGType& gen,
         uniform_real_distribution<double>& random_01)
 {
-	unsigned int number_of_infection = floor(net.size()*fraction);
-	NodeLabel i;
-	while (net.get_Inode_number() < number_of_infection)
-	{
-		i = floor(random_01(gen)*net.size());
-		if (net.is_susceptible(i))
-		{
-			net.infection(i);
-		}
-	}
+    size_t N = net.size();
+    size_t number_of_infection = floor(N*fraction);
+    if (net.get_Inode_number() >= number_of_infection)
+    {
+        return;
+    }
+    size_t number = min(number_of_infection - net.get_Inode_number(),
+            net.get_Snode_vector().size());
+    vector<NodeLabel> node_vector;
+    node_vector.reserve(number);
+
+    //label at position i of the shuffled labels
+    bool dense = (8*number > N);
+    vector<NodeLabel> label_vector;
+    unordered_map<size_t, NodeLabel> label_map;
+    if (dense)
+    {
+        label_vector.resize(N);
+        iota(label_vector.begin(), label_vector.end(), 0);
+    }
+    auto label = [&](size_t i)
+    {
+        if (dense)
+        {
+            return label_vector[i];
+        }
+        auto it = label_map.find(i);
+        return (it == label_map.end()) ? NodeLabel(i) : it->second;
+    };
+    auto set_label = [&](size_t i, NodeLabel node)
+    {
+        if (dense)
+        {
+            label_vector[i] = node;
+        }
+        else
+        {
+            label_map[i] = node;
+        }
+    };
+
+    for (size_t i = 0; i < N and node_vector.size() < number; i++)
+    {
+        size_t j = i + floor(random_01(gen)*(N - i));
+        NodeLabel node = label(j);
+        set_label(j, label(i));
+        if (net.is_susceptible(node))
+        {
+            node_vector.push_back(node);
+        }
+    }
+    net.infection(node_vector);
 }
 
 /**
  * \brief Choose between infection, recovery or immunity loss event
  * \param[in] net a reference to an object StaticNetworkSIR
  * \param[in] gen a reference to a random number generator
+ * \return the event that took place
  */
-void update_event(StaticNetworkSIR& net, RNGType& gen,
+Event update_event(StaticNetworkSIR& net, RNGType& gen,
         uniform_real_distribution<double>& random_01,
         vector<pair<NodeLabel,NodeLabel>>& transmission_vector, bool tracing)
 {
+    Event event;
 	GroupIndex group_index = (net.get_event_tree()).get_leaf_index(
 		random_01(gen));
 
@@ -80,6 +150,7 @@ void update_event(StaticNetworkSIR& net, RNGType& gen,
 	r = random_01(gen);
 	//Determine which type of event
 	NodeLabel node = propensity_group[in_group_index].first;
+    event.node = node;
     if (net.is_infected(node))
 	{
 		//the node is infected - infection or recovery
@@ -87,17 +158,21 @@ void update_event(StaticNetworkSIR& net, RNGType& gen,
 		{
 			//recovery
 			net.recovery(group_index, in_group_index);
+            event.type = RECOVERY_EVENT;
 		}
 		else
 		{
             r = random_01(gen);
 			//infection attempt of a neighbor
-			const vector<NodeLabel>& neighbor_vector = net.get_neighbor_vector(node);
+			NeighborRange neighbor_vector = net.get_neighbor_vector(node);
 			NodeLabel neighbor_node = neighbor_vector[floor(r*
 				neighbor_vector.size())];
 			if (net.is_susceptible(neighbor_node))
 			{
 				net.infection(neighbor_node);
+                event.type = INFECTION_EVENT;
+                event.node = neighbor_node;
+                event.source = node;
                 if (tracing)
                 {
                     transmission_vector.emplace_back(node,neighbor_node);
@@ -109,7 +184,9 @@ void update_event(StaticNetworkSIR& net, RNGType& gen,
 	{
 		//immunity loss event
 		net.immunity_loss(group_index, in_group_index);
+        event.type = IMMUNITY_LOSS_EVENT;
 	}
+    return event;
 }
 
 /**
@@ -129,7 +206,7 @@ double get_lifetime(StaticNetworkSIR& net, RNGType& gen,
  * \param[in] gen a reference to a RNG
  */
 double get_lifetime(StaticNetworkSIR& net, RNGType& gen,
-       double (&log_table)[TABLE_SIZE])
+       const double* log_table)
 {
     return (log_table[INDEX_MAP(gen())]/(net.get_event_tree()).get_value());
 }
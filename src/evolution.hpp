@@ -10,6 +10,7 @@
 #define EVOLUTION_HPP_
 
 #include <StaticNetworkSIR.hpp>
+#include <Observer.hpp>
 #include <random>
 #include "pcg-cpp/include/pcg_random.hpp"
 
@@ -22,13 +23,14 @@ typedef pcg32 RNGType;
 
 constexpr const uint32_t TABLE_SIZE = 100000;
 uint32_t INDEX_MAP(uint32_t NUM);
+const double* get_log_table();
 
 
 
 void infect_fraction(StaticNetworkSIR& net, double fraction, RNGType& gen,
         std::uniform_real_distribution<double>& random_01);
 
-void update_event(StaticNetworkSIR& net, RNGType& gen,
+Event update_event(StaticNetworkSIR& net, RNGType& gen,
         std::uniform_real_distribution<double>& random_01,
         std::vector<std::pair<NodeLabel,NodeLabel>>& transmission_vector,
         bool tracing = false);
@@ -37,7 +39,7 @@ double get_lifetime(StaticNetworkSIR& net, RNGType& gen,
         std::uniform_real_distribution<double>& random_01);
 
 double get_lifetime(StaticNetworkSIR& net, RNGType& gen,
-        double (&log_table)[TABLE_SIZE]);
+        const double* log_table);
 
 //void update_history(StaticNetworkSIR& net, unsigned int max_configuration,
 	//std::vector<Configuration>& history_vector, RNGType& gen);
@@ -0,0 +1,297 @@
+/**
+* \file generators.cpp
+* \brief Functions for the random network generators
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#include <generators.hpp>
+#include <parallel.hpp>
+#include <evolution.hpp>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <cmath>
+
+using namespace std;
+
+namespace net
+{//start of namespace net
+
+//Number of blocks of the parallel generators. Block b draws its random
+//numbers from the stream b of the seed, hence the network only depends on
+//the seed, not on the number of threads.
+static const size_t GENERATOR_BLOCK_NUMBER = 256;
+
+typedef vector<vector<pair<NodeLabel, NodeLabel> > > EdgeBlockVector;
+
+/**
+ * \brief Erdos-Renyi network G(N,p), where each pair of nodes is joined with
+ *  probability p. The pairs (v,w), v < w, are visited in the order of their
+ *  index w(w-1)/2 + v and the number of pairs skipped before the next edge
+ *  is drawn from a geometric distribution (Batagelj-Brandes), so the cost is
+ *  proportional to the number of edges. The pairs are split in blocks of
+ *  consecutive indices generated in parallel.
+ * \param[in] size number of nodes
+ * \param[in] probability probability of each edge
+ * \param[in] seed seed for the random number generators
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ */
+Network erdos_renyi_network(size_t size, double probability,
+        unsigned int seed, unsigned int thread_number)
+{
+    if (probability < 0 or probability > 1)
+    {
+        throw invalid_argument("The probability must be in [0,1]");
+    }
+    size_t N = size;
+    size_t block_number = max(min(N, GENERATOR_BLOCK_NUMBER), size_t(1));
+
+    //first node w of each block, with about the same number of pairs
+    double pair_number = 0.5*N*(N - 1.);
+    vector<uint64_t> first_vector(block_number+1, N);
+    first_vector[0] = 0;
+    for (size_t block = 1; block < block_number; block++)
+    {
+        double pairs = pair_number*block/block_number;
+        first_vector[block] = min(max(uint64_t(ceil(
+            0.5 + sqrt(0.25 + 2*pairs))), first_vector[block-1]), uint64_t(N));
+    }
+
+    EdgeBlockVector edge_list_vector(block_number);
+    parallel_for(block_number, thread_number, [&](size_t block)
+    {
+        if (probability == 0)
+        {
+            return;
+        }
+        RNGType gen(seed, block);
+        uniform_real_distribution<double> random_01(0., 1.);
+        double log_complement = log1p(-probability);
+        uint64_t w = first_vector[block];
+        uint64_t next = w*(w-1)/2; //index of the next pair
+        uint64_t last = first_vector[block+1]*(first_vector[block+1]-1)/2;
+        auto& edge_list = edge_list_vector[block];
+        edge_list.reserve(probability*(last - next)*1.01 + 16);
+        while (next < last)
+        {
+            double skip = floor(log1p(-random_01(gen))/log_complement);
+            if (skip >= double(last - next))
+            {
+                break;
+            }
+            next += static_cast<uint64_t>(skip);
+            while (w*(w+1)/2 <= next)
+            {
+                w++;
+            }
+            edge_list.emplace_back(next - w*(w-1)/2, w);
+            next++;
+        }
+    });
+    return Network(edge_list_vector, N, thread_number);
+}
+
+/**
+ * \brief Network drawn from the configuration model: the stubs of the nodes
+ *  are matched uniformly at random. Self-loops and multiple edges are kept,
+ *  so that every node has exactly its degree. The sequence can be read with
+ *  input_degree_sequence.
+ * \param[in] degree_sequence degree of each node, of even sum
+ * \param[in] seed seed for the random number generator
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ */
+Network configuration_model_network(const vector<size_t>& degree_sequence,
+        unsigned int seed, unsigned int thread_number)
+{
+    size_t N = degree_sequence.size();
+    size_t stub_number = accumulate(degree_sequence.begin(),
+        degree_sequence.end(), size_t(0));
+    if (stub_number % 2 != 0)
+    {
+        throw invalid_argument("The sum of the degrees must be even");
+    }
+    vector<NodeLabel> stub_vector;
+    stub_vector.reserve(stub_number);
+    for (size_t node = 0; node < N; node++)
+    {
+        stub_vector.insert(stub_vector.end(), degree_sequence[node], node);
+    }
+    RNGType gen(seed, 0);
+    shuffle(stub_vector.begin(), stub_vector.end(), gen);
+
+    //consecutive stubs are matched
+    size_t edge_number = stub_number/2;
+    size_t block_number = max(min(edge_number, GENERATOR_BLOCK_NUMBER),
+        size_t(1));
+    EdgeBlockVector edge_list_vector(block_number);
+    parallel_for(block_number, thread_number, [&](size_t block)
+    {
+        size_t first = edge_number*block/block_number;
+        size_t last = edge_number*(block+1)/block_number;
+        auto& edge_list = edge_list_vector[block];
+        edge_list.reserve(last - first);
+        for (size_t edge = first; edge < last; edge++)
+        {
+            edge_list.emplace_back(stub_vector[2*edge], stub_vector[2*edge+1]);
+        }
+    });
+    vector<NodeLabel>().swap(stub_vector);
+    return Network(edge_list_vector, N, thread_number);
+}
+
+/**
+ * \brief Chung-Lu network, where nodes i and j are joined with probability
+ *  min(w_i w_j/S, 1), S being the sum of the weights, so that the expected
+ *  degree of node i is about w_i. The nodes are sorted by decreasing weight,
+ *  so that the probability decreases along a row of the adjacency matrix:
+ *  candidates are drawn by geometric skipping with the current probability
+ *  and accepted with the ratio to the previous one (Miller-Hagberg). The
+ *  rows are split in blocks with about the same expected number of edges.
+ * \param[in] weight_vector expected degree of each node
+ * \param[in] seed seed for the random number generators
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ */
+Network chung_lu_network(const vector<double>& weight_vector,
+        unsigned int seed, unsigned int thread_number)
+{
+    size_t N = weight_vector.size();
+    vector<NodeLabel> order_vector(N);
+    iota(order_vector.begin(), order_vector.end(), 0);
+    stable_sort(order_vector.begin(), order_vector.end(),
+        [&](NodeLabel node1, NodeLabel node2)
+        {return weight_vector[node1] > weight_vector[node2];});
+    vector<double> weight(N);
+    double weight_sum = 0;
+    for (size_t i = 0; i < N; i++)
+    {
+        weight[i] = weight_vector[order_vector[i]];
+        if (weight[i] < 0 or not isfinite(weight[i]))
+        {
+            throw invalid_argument("The weights must be finite and positive");
+        }
+        weight_sum += weight[i];
+    }
+
+    //expected number of edges up to each row, to balance the blocks
+    vector<double> cost_vector(N+1, 0.);
+    double remaining_sum = weight_sum;
+    for (size_t i = 0; i < N; i++)
+    {
+        remaining_sum -= weight[i];
+        cost_vector[i+1] = cost_vector[i] + weight[i]*max(remaining_sum, 0.);
+    }
+    size_t block_number = max(min(N, GENERATOR_BLOCK_NUMBER), size_t(1));
+    vector<size_t> first_vector(block_number+1, N);
+    first_vector[0] = 0;
+    for (size_t block = 1; block < block_number; block++)
+    {
+        first_vector[block] = lower_bound(cost_vector.begin(),
+            cost_vector.end() - 1, cost_vector[N]*block/block_number)
+            - cost_vector.begin();
+    }
+    vector<double>().swap(cost_vector);
+
+    EdgeBlockVector edge_list_vector(block_number);
+    parallel_for(block_number, thread_number, [&](size_t block)
+    {
+        if (weight_sum <= 0)
+        {
+            return;
+        }
+        RNGType gen(seed, block);
+        uniform_real_distribution<double> random_01(0., 1.);
+        auto& edge_list = edge_list_vector[block];
+        for (size_t u = first_vector[block]; u < first_vector[block+1]; u++)
+        {
+            size_t v = u + 1;
+            double probability = (v < N) ?
+                min(weight[u]*weight[v]/weight_sum, 1.) : 0.;
+            while (v < N and probability > 0)
+            {
+                if (probability < 1)
+                {
+                    double skip = floor(log1p(-random_01(gen))
+                        /log1p(-probability));
+                    if (skip >= double(N - v))
+                    {
+                        break;
+                    }
+                    v += static_cast<size_t>(skip);
+                }
+                double next_probability = min(weight[u]*weight[v]/weight_sum,
+                    1.);
+                if (random_01(gen) < next_probability/probability)
+                {
+                    edge_list.emplace_back(order_vector[u], order_vector[v]);
+                }
+                probability = next_probability;
+                v++;
+            }
+        }
+    });
+    return Network(edge_list_vector, N, thread_number);
+}
+
+/**
+ * \brief Barabasi-Albert network. The first new node is joined to the m
+ *  initial nodes; each following node is joined to m distinct nodes chosen
+ *  with probability proportional to their degree, by drawing uniformly in
+ *  the list of the edge ends. The growth is sequential; only the adjacency
+ *  is built on multiple threads.
+ * \param[in] size number of nodes
+ * \param[in] edge_number number of edges m of each new node
+ * \param[in] seed seed for the random number generator
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ */
+Network barabasi_albert_network(size_t size, size_t edge_number,
+        unsigned int seed, unsigned int thread_number)
+{
+    size_t N = size;
+    size_t m = edge_number;
+    if (m < 1 or m >= N)
+    {
+        throw invalid_argument(
+            "The number of edges per node must be in [1, size)");
+    }
+    RNGType gen(seed, 0);
+    EdgeBlockVector edge_list_vector(1);
+    auto& edge_list = edge_list_vector[0];
+    edge_list.reserve(m*(N - m));
+    vector<NodeLabel> end_vector; //both ends of every edge
+    end_vector.reserve(2*m*(N - m));
+    vector<NodeLabel> target_vector;
+    for (size_t node = 0; node < m; node++)
+    {
+        target_vector.push_back(node);
+    }
+    for (size_t node = m; node < N; node++)
+    {
+        if (node > m)
+        {
+            target_vector.clear();
+            uniform_int_distribution<size_t> random_end(0,
+                end_vector.size()-1);
+            while (target_vector.size() < m)
+            {
+                NodeLabel target = end_vector[random_end(gen)];
+                if (find(target_vector.begin(), target_vector.end(), target)
+                    == target_vector.end())
+                {
+                    target_vector.push_back(target);
+                }
+            }
+        }
+        for (NodeLabel target : target_vector)
+        {
+            edge_list.emplace_back(node, target);
+            end_vector.push_back(node);
+            end_vector.push_back(target);
+        }
+    }
+    vector<NodeLabel>().swap(end_vector);
+    return Network(edge_list_vector, N, thread_number);
+}
+
+}//end of namespace net
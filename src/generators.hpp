@@ -0,0 +1,33 @@
+/**
+* \file generators.hpp
+* \brief Header file for the random network generators
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#ifndef GENERATORS_HPP_
+#define GENERATORS_HPP_
+
+#include <Network.hpp>
+#include <vector>
+
+namespace net
+{//start of namespace net
+
+Network erdos_renyi_network(std::size_t size, double probability,
+        unsigned int seed, unsigned int thread_number = 1);
+
+Network configuration_model_network(
+        const std::vector<std::size_t>& degree_sequence, unsigned int seed,
+        unsigned int thread_number = 1);
+
+Network chung_lu_network(const std::vector<double>& weight_vector,
+        unsigned int seed, unsigned int thread_number = 1);
+
+Network barabasi_albert_network(std::size_t size, std::size_t edge_number,
+        unsigned int seed, unsigned int thread_number = 1);
+
+}//end of namespace net
+
+#endif /* GENERATORS_HPP_ */
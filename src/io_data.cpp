@@ -7,12 +7,35 @@
 */
 
 #include <io_data.hpp>
+#include <TransmissionWriter.hpp>
+#include <MappedFile.hpp>
+#include <parallel.hpp>
+#include <compaction.hpp>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <thread>
 
 using namespace std;
 
 namespace net
 {//start of namespace net
 
+//Define structure for the header of a network file
+struct NetworkFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t label_size;
+	uint32_t flags;
+	uint64_t node_number;
+	uint64_t neighbor_number;
+	uint64_t offset_position;
+	uint64_t neighbor_position;
+	uint64_t permutation_position;
+	uint64_t file_size;
+};
+
 /**
  * \brief Output edge list to a file
  * \param[in] path path name to the file
@@ -24,7 +47,7 @@ void output_edge_list(string path, vector<pair<NodeLabel, NodeLabel> >
 	ofstream outStream;
 	outStream.open(path, ios::out);
 
-	for (int i = 0; i < edge_list.size(); i++)
+	for (size_t i = 0; i < edge_list.size(); i++)
 	{
 		outStream << edge_list[i].first << " " << edge_list[i].second << endl;
 	}
@@ -32,28 +55,215 @@ void output_edge_list(string path, vector<pair<NodeLabel, NodeLabel> >
 	outStream.close();
 }
 
+/**
+ * \brief Move to the start of the next line
+ * \param[in] position pointer in the text, moved past the end of the line
+ * \param[in] end pointer past the last character
+ */
+static void skip_line(const char*& position, const char* end)
+{
+	const void* newline = memchr(position, '\n', end - position);
+	position = (newline != nullptr) ?
+		static_cast<const char*>(newline) + 1 : end;
+}
+
+/**
+ * \brief Parse a node label written in decimal
+ * \param[in] position pointer to the first digit, moved past the last one
+ * \param[in] end pointer past the last character
+ */
+template <typename Label>
+static Label parse_label(const char*& position, const char* end)
+{
+	if (position == end or *position < '0' or *position > '9')
+	{
+		throw runtime_error("Malformed line in edge list");
+	}
+	Label value = 0;
+	while (position < end and *position >= '0' and *position <= '9')
+	{
+		Label digit = *position - '0';
+		if (value > (numeric_limits<Label>::max() - digit)/10)
+		{
+			throw runtime_error("Node label too large in edge list");
+		}
+		value = 10*value + digit;
+		position++;
+	}
+	return value;
+}
+
+/**
+ * \brief Read the next edge of a text edge list. Blank lines and lines
+ *  starting with '#' or '%' are skipped; the two nodes are separated by
+ *  spaces, tabs or a comma, and the rest of the line is ignored.
+ * \param[in] position pointer in the text, moved past the line of the edge
+ * \param[in] end pointer past the last character
+ * \param[out] edge edge read
+ * \return false if there is no edge left
+ */
+template <typename Label>
+static bool next_edge(const char*& position, const char* end,
+	pair<Label, Label>& edge)
+{
+	while (position < end)
+	{
+		while (position < end and (*position == ' ' or *position == '\t'
+			or *position == '\r'))
+		{
+			position++;
+		}
+		if (position == end)
+		{
+			return false;
+		}
+		if (*position == '\n')
+		{
+			position++;
+			continue;
+		}
+		if (*position == '#' or *position == '%')
+		{
+			skip_line(position, end);
+			continue;
+		}
+		edge.first = parse_label<Label>(position, end);
+		while (position < end and (*position == ' ' or *position == '\t'
+			or *position == ','))
+		{
+			position++;
+		}
+		edge.second = parse_label<Label>(position, end);
+		skip_line(position, end);
+		return true;
+	}
+	return false;
+}
+
+/**
+ * \brief Split a text in chunks made of whole lines
+ * \param[in] data pointer to the text
+ * \param[in] size number of characters
+ * \param[in] chunk_number number of chunks
+ * \return pointers to the start of each chunk, followed by the end
+ */
+static vector<const char*> split_lines(const char* data, size_t size,
+	size_t chunk_number)
+{
+	vector<const char*> boundary_vector(chunk_number+1, data + size);
+	boundary_vector[0] = data;
+	for (size_t chunk = 1; chunk < chunk_number; chunk++)
+	{
+		const char* position = max(data + (size/chunk_number)*chunk,
+			boundary_vector[chunk-1]);
+		skip_line(position, data + size);
+		boundary_vector[chunk] = position;
+	}
+	return boundary_vector;
+}
+
 /**
  * \brief Input  the edge list from file
  * \param[in] path path name to the file
  */
 vector<pair<NodeLabel, NodeLabel> > input_edge_list(string path)
 {
-	ifstream in_stream;
-	in_stream.open(path, ios::in);
-	string line;
-
+	MappedFile file(path);
+	const char* position = file.data();
+	const char* end = file.data() + file.size();
 	vector<pair<NodeLabel, NodeLabel> > edge_list;
+	pair<NodeLabel, NodeLabel> edge;
+	while (next_edge(position, end, edge))
+	{
+		edge_list.push_back(edge);
+	}
+	return edge_list;
+}
 
-	while(getline(in_stream,line))
+/**
+ * \brief Edges of a chunk of lines of a text edge list, for the constructor
+ *  of Network from groups of edges
+ */
+struct TextEdgeGroup
+{
+	const vector<const char*>& boundary_vector; //start of each chunk
+
+	template <class Function>
+	void operator()(size_t chunk, Function function) const
 	{
+		const char* position = boundary_vector[chunk];
 		pair<NodeLabel, NodeLabel> edge;
-		stringstream line_stream(line);
-		line_stream >> edge.first >> edge.second;
-		edge_list.push_back(edge);
+		while (next_edge(position, boundary_vector[chunk+1], edge))
+		{
+			function(edge.first, edge.second);
+		}
 	}
-	in_stream.close();
+};
 
-	return edge_list;
+/**
+ * \brief Build a network from a text edge list, without the intermediate
+ *  edge list and adjacency lists. The file is mapped in memory and split in
+ *  chunks of lines parsed on multiple threads: once for the number of nodes,
+ *  once to count the neighbors of the nodes and once to place them. The
+ *  neighbors of each node are sorted, whatever the number of threads.
+ * \param[in] path path name to the file
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ */
+Network load_edge_list(const string& path, unsigned int thread_number)
+{
+	if (thread_number == 0)
+	{
+		thread_number = max(thread::hardware_concurrency(), 1u);
+	}
+	MappedFile file(path);
+	//chunks of at least 1 MB, a few per thread to balance the load
+	size_t chunk_number = max(min(size_t(4)*thread_number,
+		file.size() >> 20), size_t(1));
+	vector<const char*> boundary_vector = split_lines(file.data(),
+		file.size(), chunk_number);
+	return Network(chunk_number, TextEdgeGroup{boundary_vector}, 0,
+		thread_number);
+}
+
+/**
+ * \brief Build a simple network from a text edge list with arbitrary node
+ *  identifiers (unsigned 64-bit integers). The file is parsed as with
+ *  load_edge_list, the identifiers are relabeled from 0 in increasing order,
+ *  and the self-loops and duplicated edges are removed.
+ * \param[in] path path name to the file
+ * \param[out] identifier_vector identifier of each node with an edge
+ * \param[in] size number of nodes, so that isolated nodes can be added after
+ *  the identified ones (0: number of identifiers)
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ */
+Network load_labeled_edge_list(const string& path,
+	vector<uint64_t>& identifier_vector, size_t size,
+	unsigned int thread_number)
+{
+	if (thread_number == 0)
+	{
+		thread_number = max(thread::hardware_concurrency(), 1u);
+	}
+	IdentifierEdgeBlockVector chunk_edge_list;
+	{
+		MappedFile file(path);
+		size_t chunk_number = max(min(size_t(4)*thread_number,
+			file.size() >> 20), size_t(1));
+		vector<const char*> boundary_vector = split_lines(file.data(),
+			file.size(), chunk_number);
+		chunk_edge_list.resize(chunk_number);
+		parallel_for(chunk_number, thread_number, [&](size_t chunk)
+		{
+			const char* position = boundary_vector[chunk];
+			pair<uint64_t, uint64_t> edge;
+			while (next_edge(position, boundary_vector[chunk+1], edge))
+			{
+				chunk_edge_list[chunk].push_back(edge);
+			}
+		});
+	}
+	return relabeled_network(chunk_edge_list, identifier_vector, size,
+		thread_number);
 }
 
 /**
@@ -108,4 +318,337 @@ vector<size_t> input_degree_sequence(string path)
 }
 
 
-}//end of namespace net
\ No newline at end of file
+/**
+ * \brief Write the adjacency of a network in binary form (degree of each
+ *  node followed by the concatenated neighbor vectors)
+ * \param[in] out output stream
+ * \param[in] network network to write
+ */
+void write_network(ostream& out, const Network& network)
+{
+	vector<uint64_t> degree_vector(network.size());
+	for (NodeLabel node = 0; node < network.size(); node++)
+	{
+		degree_vector[node] = network.degree(node);
+	}
+	write_binary_vector(out, degree_vector);
+	write_binary(out, static_cast<uint64_t>(network.get_neighbor_number()));
+	out.write(reinterpret_cast<const char*>(network.get_neighbor_data()),
+		network.get_neighbor_number()*sizeof(NodeLabel));
+}
+
+/**
+ * \brief Read a network written by write_network. The order of the
+ *  neighbors of each node is preserved.
+ * \param[in] in input stream
+ */
+Network read_network(istream& in)
+{
+	vector<uint64_t> degree_vector = read_binary_vector<uint64_t>(in);
+	vector<NodeLabel> neighbor_vector = read_binary_vector<NodeLabel>(in);
+	vector<uint64_t> offset_vector(degree_vector.size()+1, 0);
+	for (size_t node = 0; node < degree_vector.size(); node++)
+	{
+		offset_vector[node+1] = offset_vector[node] + degree_vector[node];
+	}
+	if (offset_vector.back() != neighbor_vector.size())
+	{
+		throw runtime_error("Corrupted network data");
+	}
+	return Network(move(offset_vector), move(neighbor_vector));
+}
+
+/**
+ * \brief Write a network to a binary file that can be mapped in memory by
+ *  input_network_file
+ * \param[in] path path name to the file
+ * \param[in] network network to write
+ * \param[in] degree_sorted if true, the nodes are relabeled by decreasing
+ *  degree and the original labels are stored in the file
+ */
+void output_network_file(const string& path, const Network& network,
+	bool degree_sorted)
+{
+	size_t N = network.size();
+	size_t M = network.get_neighbor_number();
+	const uint64_t* offset = network.get_offset_data();
+	const NodeLabel* neighbor = network.get_neighbor_data();
+
+	vector<NodeLabel> permutation_vector;
+	vector<uint64_t> offset_vector;
+	vector<NodeLabel> neighbor_vector;
+	if (degree_sorted)
+	{
+		//new label -> original label, and the inverse
+		permutation_vector.resize(N);
+		for (size_t node = 0; node < N; node++)
+		{
+			permutation_vector[node] = node;
+		}
+		stable_sort(permutation_vector.begin(), permutation_vector.end(),
+			[&](NodeLabel node1, NodeLabel node2)
+			{return network.degree(node1) > network.degree(node2);});
+		vector<NodeLabel> label_vector(N);
+		for (size_t node = 0; node < N; node++)
+		{
+			label_vector[permutation_vector[node]] = node;
+		}
+
+		offset_vector.assign(N+1, 0);
+		neighbor_vector.reserve(M);
+		for (size_t node = 0; node < N; node++)
+		{
+			for (NodeLabel neighbor :
+				network.get_neighbor_vector(permutation_vector[node]))
+			{
+				neighbor_vector.push_back(label_vector[neighbor]);
+			}
+			offset_vector[node+1] = neighbor_vector.size();
+		}
+		offset = offset_vector.data();
+		neighbor = neighbor_vector.data();
+	}
+
+	NetworkFileHeader header;
+	header.magic = NETWORK_FILE_MAGIC;
+	header.version = NETWORK_FILE_VERSION;
+	header.label_size = sizeof(NodeLabel);
+	header.flags = degree_sorted ? NETWORK_FILE_PERMUTATION : 0;
+	header.node_number = N;
+	header.neighbor_number = M;
+	header.offset_position = sizeof(NetworkFileHeader);
+	header.neighbor_position = header.offset_position + (N+1)*sizeof(uint64_t);
+	uint64_t neighbor_end = header.neighbor_position + M*sizeof(NodeLabel);
+	header.permutation_position = degree_sorted ? (neighbor_end + 7)/8*8 : 0;
+	header.file_size = degree_sorted ?
+		header.permutation_position + N*sizeof(NodeLabel) : neighbor_end;
+
+	ofstream out(path, ios::out | ios::binary);
+	if (not out)
+	{
+		throw runtime_error("Cannot open file " + path);
+	}
+	write_binary(out, header);
+	out.write(reinterpret_cast<const char*>(offset), (N+1)*sizeof(uint64_t));
+	out.write(reinterpret_cast<const char*>(neighbor), M*sizeof(NodeLabel));
+	if (degree_sorted)
+	{
+		const char padding[8] = {};
+		out.write(padding, header.permutation_position - neighbor_end);
+		out.write(reinterpret_cast<const char*>(permutation_vector.data()),
+			N*sizeof(NodeLabel));
+	}
+	out.close();
+	if (not out)
+	{
+		throw runtime_error("Failed to write network file " + path);
+	}
+}
+
+/**
+ * \brief Read and check the header of a network file
+ * \param[in] file mapped network file
+ * \param[in] path path name to the file, for the error messages
+ */
+static NetworkFileHeader read_network_file_header(const MappedFile& file,
+	const string& path)
+{
+	NetworkFileHeader header;
+	if (file.size() < sizeof(NetworkFileHeader))
+	{
+		throw runtime_error("Not a network file: " + path);
+	}
+	memcpy(&header, file.data(), sizeof(NetworkFileHeader));
+	if (header.magic != NETWORK_FILE_MAGIC)
+	{
+		throw runtime_error("Not a network file: " + path);
+	}
+	if (header.version != NETWORK_FILE_VERSION
+		or header.label_size != sizeof(NodeLabel))
+	{
+		throw runtime_error("Unsupported network file version: " + path);
+	}
+	//sizes are bounded first, so that the positions below do not overflow
+	if (header.file_size != file.size()
+		or header.node_number > file.size()
+		or header.neighbor_number > file.size()
+		or header.offset_position > file.size()
+		or header.neighbor_position > file.size()
+		or header.permutation_position > file.size())
+	{
+		throw runtime_error("Corrupted network file: " + path);
+	}
+	uint64_t neighbor_end = header.neighbor_position
+		+ header.neighbor_number*sizeof(NodeLabel);
+	bool permutation = header.flags & NETWORK_FILE_PERMUTATION;
+	if (header.offset_position % 8 != 0
+		or header.neighbor_position % 8 != 0
+		or header.permutation_position % 8 != 0
+		or header.offset_position < sizeof(NetworkFileHeader)
+		or header.neighbor_position < header.offset_position
+			+ (header.node_number+1)*sizeof(uint64_t)
+		or neighbor_end > file.size()
+		or (permutation and (header.permutation_position < neighbor_end
+			or header.permutation_position
+			+ header.node_number*sizeof(NodeLabel) > file.size())))
+	{
+		throw runtime_error("Corrupted network file: " + path);
+	}
+	return header;
+}
+
+/**
+ * \brief Map a network file written by output_network_file in memory. The
+ *  arrays are used in place, read-only: nothing is parsed nor copied, and the
+ *  pages are shared by all the processes mapping the same file.
+ * \param[in] path path name to the file
+ * \param[in] verify if true, check that the offsets are increasing and that
+ *  the neighbors are valid nodes, in one pass over the arrays; a corrupted
+ *  file would otherwise make the processes read and write out of bounds
+ */
+Network input_network_file(const string& path, bool verify)
+{
+	shared_ptr<MappedFile> file = make_shared<MappedFile>(path);
+	NetworkFileHeader header = read_network_file_header(*file, path);
+	size_t N = header.node_number;
+	const uint64_t* offset = reinterpret_cast<const uint64_t*>(
+		file->data() + header.offset_position);
+	const NodeLabel* neighbor = reinterpret_cast<const NodeLabel*>(
+		file->data() + header.neighbor_position);
+	if (offset[0] != 0 or offset[N] != header.neighbor_number)
+	{
+		throw runtime_error("Corrupted network file: " + path);
+	}
+	if (verify)
+	{
+		for (size_t node = 0; node < N; node++)
+		{
+			if (offset[node+1] < offset[node])
+			{
+				throw runtime_error("Corrupted network file: " + path);
+			}
+		}
+		for (size_t index = 0; index < header.neighbor_number; index++)
+		{
+			if (neighbor[index] >= N)
+			{
+				throw runtime_error("Corrupted network file: " + path);
+			}
+		}
+	}
+	return Network(file, offset, neighbor, N);
+}
+
+/**
+ * \brief Original label of each node of a network file written with
+ *  degree_sorted, empty otherwise
+ * \param[in] path path name to the file
+ */
+vector<NodeLabel> input_network_permutation(const string& path)
+{
+	MappedFile file(path);
+	NetworkFileHeader header = read_network_file_header(file, path);
+	if (not (header.flags & NETWORK_FILE_PERMUTATION))
+	{
+		return vector<NodeLabel>();
+	}
+	const NodeLabel* permutation = reinterpret_cast<const NodeLabel*>(
+		file.data() + header.permutation_position);
+	return vector<NodeLabel>(permutation, permutation + header.node_number);
+}
+
+/**
+ * \brief Decode a varint
+ * \param[in] position pointer to the first byte, moved past the varint
+ * \param[in] end pointer past the last available byte
+ */
+static uint64_t decode_varint(const char*& position, const char* end)
+{
+    uint64_t value = 0;
+    unsigned int shift = 0;
+    while (position < end and shift < 64)
+    {
+        unsigned char byte = static_cast<unsigned char>(*position++);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (byte < 0x80)
+        {
+            return value;
+        }
+        shift += 7;
+    }
+    throw runtime_error("Truncated transmission file");
+}
+
+/**
+ * \brief Input a transmission tree written by a TransmissionWriter
+ * \param[in] path path name to the file
+ * \param[out] time_vector time of each infection
+ * \param[out] source_vector infecting node of each infection
+ * \param[out] node_vector infected node of each infection
+ */
+void input_transmission_tree(string path, vector<double>& time_vector,
+        vector<NodeLabel>& source_vector, vector<NodeLabel>& node_vector)
+{
+    ifstream in_stream(path, ios::in | ios::binary);
+    if (not in_stream)
+    {
+        throw runtime_error("Cannot open file " + path);
+    }
+    if (read_binary<uint32_t>(in_stream) != TRANSMISSION_MAGIC)
+    {
+        throw runtime_error("Not a transmission file");
+    }
+    if (read_binary<uint32_t>(in_stream) != TRANSMISSION_VERSION)
+    {
+        throw runtime_error("Unsupported transmission file version");
+    }
+    time_vector.clear();
+    source_vector.clear();
+    node_vector.clear();
+
+    //records are decoded by chunks; an incomplete record at the end of a
+    //chunk is moved to the beginning of the next one
+    const size_t max_record_size = sizeof(float) + 2*10;
+    vector<char> chunk(1 << 20);
+    size_t chunk_size = 0;
+    double time = 0.;
+    bool end_of_file = false;
+    while (not end_of_file or chunk_size > 0)
+    {
+        if (not end_of_file)
+        {
+            in_stream.read(chunk.data() + chunk_size,
+                    chunk.size() - chunk_size);
+            chunk_size += in_stream.gcount();
+            end_of_file = not in_stream;
+        }
+        const char* position = chunk.data();
+        const char* end = chunk.data() + chunk_size;
+        while (true)
+        {
+            size_t remaining = static_cast<size_t>(end - position);
+            if (remaining < max_record_size
+                    and (not end_of_file or remaining == 0))
+            {
+                break;
+            }
+            if (remaining < sizeof(float))
+            {
+                throw runtime_error("Truncated transmission file");
+            }
+            float time_difference;
+            copy(position, position + sizeof(float),
+                    reinterpret_cast<char*>(&time_difference));
+            position += sizeof(float);
+            time += time_difference;
+            time_vector.push_back(time);
+            source_vector.push_back(decode_varint(position, end));
+            node_vector.push_back(decode_varint(position, end));
+        }
+        chunk_size = end - position;
+        copy(position, end, chunk.begin());
+    }
+}
+
+
+}//end of namespace net
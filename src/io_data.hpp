@@ -13,6 +13,8 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include <stdexcept>
+#include <cstdint>
 #include <Network.hpp>
 
 
@@ -20,15 +22,109 @@
 namespace net
 {//start of namespace net
 
+//Binary network file format
+constexpr const uint32_t NETWORK_FILE_MAGIC = 0x52475053; //"SPGR"
+constexpr const uint32_t NETWORK_FILE_VERSION = 1;
+constexpr const uint32_t NETWORK_FILE_PERMUTATION = 1; //flag
 
-void output_edge_list(std::string path, std::vector<std::pair<unsigned int, 
-	unsigned int> > edge_list);
+/*
+ * A network file is made to be mapped in memory and used in place. It starts
+ * with a header of 64 bytes (native byte order):
+ *
+ *   uint32 magic number, version, size of a node label, flags
+ *   uint64 number of nodes N, number of neighbors M (twice the edges)
+ *   uint64 byte position of the offsets, neighbors and permutation (0 if
+ *          absent), size of the file
+ *
+ * followed by the N+1 offsets (uint64) and the M neighbors (node labels) of
+ * the compressed sparse row adjacency, and optionally by the permutation (N
+ * node labels) giving the original label of each node when the nodes were
+ * relabeled by decreasing degree. Every array starts on 8 bytes.
+ */
+
+void output_edge_list(std::string path, std::vector<std::pair<NodeLabel,
+	NodeLabel> > edge_list);
 
 std::vector<std::pair<NodeLabel, NodeLabel> > input_edge_list(
 	std::string	path);
+Network load_edge_list(const std::string& path,
+	unsigned int thread_number = 0);
+Network load_labeled_edge_list(const std::string& path,
+	std::vector<uint64_t>& identifier_vector, std::size_t size = 0,
+	unsigned int thread_number = 0);
 std::vector<double> input_degree_distribution(std::string path);
 std::vector<std::size_t> input_degree_sequence(std::string path);
 
+//binary input/output of networks
+void write_network(std::ostream& out, const Network& network);
+Network read_network(std::istream& in);
+void output_network_file(const std::string& path, const Network& network,
+	bool degree_sorted = false);
+Network input_network_file(const std::string& path, bool verify = true);
+std::vector<NodeLabel> input_network_permutation(const std::string& path);
+
+//transmission tree written by TransmissionWriter
+void input_transmission_tree(std::string path,
+        std::vector<double>& time_vector,
+        std::vector<NodeLabel>& source_vector,
+        std::vector<NodeLabel>& node_vector);
+
+/**
+ * \brief Write a plain value in binary form
+ * \param[in] out output stream
+ * \param[in] value value to write
+ */
+template <typename T>
+void write_binary(std::ostream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * \brief Write a vector of plain values in binary form, preceded by its size
+ * \param[in] out output stream
+ * \param[in] data vector to write
+ */
+template <typename T>
+void write_binary_vector(std::ostream& out, const std::vector<T>& data)
+{
+    write_binary(out, static_cast<uint64_t>(data.size()));
+    out.write(reinterpret_cast<const char*>(data.data()),
+        data.size()*sizeof(T));
+}
+
+/**
+ * \brief Read a plain value in binary form
+ * \param[in] in input stream
+ */
+template <typename T>
+T read_binary(std::istream& in)
+{
+    T value;
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (not in)
+    {
+        throw std::runtime_error("Unexpected end of binary data");
+    }
+    return value;
+}
+
+/**
+ * \brief Read a vector of plain values written by write_binary_vector
+ * \param[in] in input stream
+ */
+template <typename T>
+std::vector<T> read_binary_vector(std::istream& in)
+{
+    std::vector<T> data(read_binary<uint64_t>(in));
+    in.read(reinterpret_cast<char*>(data.data()), data.size()*sizeof(T));
+    if (not in)
+    {
+        throw std::runtime_error("Unexpected end of binary data");
+    }
+    return data;
+}
+
 }//end of namespace net
 
 #endif /* IO_DATA_HPP_ */
\ No newline at end of file
@@ -1,8 +1,12 @@
 #include "SpreadingProcess.hpp"
+#include "QSSpreadingProcess.hpp"
 #include "BinaryTree.hpp"
+#include "generators.hpp"
 #include <vector>
 #include <utility>
 #include <iostream>
+#include <sstream>
+#include <limits>
 
 using namespace std;
 using namespace net;
@@ -19,6 +23,39 @@ int main (int argc, char *argv[])
     SpreadingProcess(edge_list,transmission_rate,recovery_rate,
             waning_immunity_rate);
 
+    //a process resumed from a checkpoint, then moved, must continue exactly
+    //like the uninterrupted one
+    Network network = erdos_renyi_network(2000, 6./2000, 42);
+    SpreadingProcess sp(network, 0.4, 1., 0.7);
+    sp.initialize_random(0.1, 42);
+    sp.evolve(5);
+    stringstream checkpoint;
+    sp.save(checkpoint);
+    SpreadingProcess loaded = SpreadingProcess::load(checkpoint);
+    SpreadingProcess resumed(move(loaded));
+    sp.evolve(5);
+    resumed.evolve(5);
+
+    QSSpreadingProcess qs(network, 0.3, 1.,
+            numeric_limits<double>::infinity());
+    qs.initialize_random(0.1, 42);
+    qs.evolve(10);
+    stringstream qs_checkpoint;
+    qs.save(qs_checkpoint);
+    QSSpreadingProcess qs_loaded = QSSpreadingProcess::load(qs_checkpoint);
+    QSSpreadingProcess qs_resumed(move(qs_loaded));
+    qs.evolve(20);
+    qs_resumed.evolve(20);
+
+    if (sp.get_time_vector() != resumed.get_time_vector()
+        or sp.get_Inode_number_vector() != resumed.get_Inode_number_vector()
+        or qs.get_qs_estimate().mean_prevalence
+            != qs_resumed.get_qs_estimate().mean_prevalence)
+    {
+        cout << "Resumed process differs from the original" << endl;
+        return 1;
+    }
+
     cout << "Hello World!" << endl;
 
     return 0;
@@ -0,0 +1,87 @@
+/**
+* \file parallel.hpp
+* \brief Header file for the parallel execution of independent tasks
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#ifndef PARALLEL_HPP_
+#define PARALLEL_HPP_
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <exception>
+#include <algorithm>
+
+namespace net
+{//start of namespace net
+
+/**
+ * \brief Call function(i) for i = 0,...,task_number-1 on multiple threads.
+ *  Tasks are handed out dynamically, hence must be independent. The first
+ *  exception thrown by a task is rethrown once all threads are joined.
+ * \param[in] task_number number of tasks
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ * \param[in] function callable taking the index of a task
+ */
+template <class Function>
+void parallel_for(std::size_t task_number, unsigned int thread_number,
+        Function function)
+{
+    if (thread_number == 0)
+    {
+        thread_number = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    if (thread_number > task_number)
+    {
+        thread_number = task_number;
+    }
+    if (thread_number <= 1)
+    {
+        for (std::size_t i = 0; i < task_number; i++)
+        {
+            function(i);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next_task(0);
+    std::vector<std::exception_ptr> exception_vector(thread_number);
+    std::vector<std::thread> thread_vector;
+    for (unsigned int t = 0; t < thread_number; t++)
+    {
+        thread_vector.emplace_back([&, t]()
+        {
+            try
+            {
+                std::size_t i;
+                while ((i = next_task++) < task_number)
+                {
+                    function(i);
+                }
+            }
+            catch (...)
+            {
+                exception_vector[t] = std::current_exception();
+                next_task = task_number; //stop the other threads
+            }
+        });
+    }
+    for (auto& thread : thread_vector)
+    {
+        thread.join();
+    }
+    for (auto& exception : exception_vector)
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+}
+
+}//end of namespace net
+
+#endif /* PARALLEL_HPP_ */
@@ -0,0 +1,254 @@
+/**
+* \file percolation.cpp
+* \brief Functions for the bond percolation estimates of SIR final sizes
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#include <percolation.hpp>
+#include <parallel.hpp>
+#include <evolution.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+using namespace std;
+
+namespace net
+{//start of namespace net
+
+//Define structure for the binomial weights of a transmissibility, restricted
+//to the number of occupied edges where they are not negligible
+struct BinomialWindow
+{
+    size_t first; //number of occupied edges of the first weight
+    vector<double> weight_vector;
+};
+
+/**
+ * \brief Binomial distribution of the number of occupied edges
+ * \param[in] edge_number number of edges
+ * \param[in] occupation probability of occupation of an edge
+ */
+static BinomialWindow binomial_window(size_t edge_number, double occupation)
+{
+    BinomialWindow window;
+    if (occupation <= 0 or occupation >= 1 or edge_number == 0)
+    {
+        window.first = (occupation >= 1) ? edge_number : 0;
+        window.weight_vector.assign(1, 1.);
+        return window;
+    }
+    double mean = edge_number*occupation;
+    double deviation = sqrt(edge_number*occupation*(1-occupation));
+    size_t first = max(floor(mean - 10*deviation) - 1, 0.);
+    size_t last = min(ceil(mean + 10*deviation) + 1, double(edge_number));
+
+    //log-probabilities, normalized after exponentiation
+    window.first = first;
+    window.weight_vector.resize(last - first + 1);
+    double log_max = -numeric_limits<double>::infinity();
+    for (size_t m = first; m <= last; m++)
+    {
+        double log_weight = lgamma(edge_number + 1.) - lgamma(m + 1.)
+            - lgamma(edge_number - m + 1.) + m*log(occupation)
+            + (edge_number - m)*log1p(-occupation);
+        window.weight_vector[m - first] = log_weight;
+        log_max = max(log_max, log_weight);
+    }
+    double norm = 0;
+    for (double& weight : window.weight_vector)
+    {
+        weight = exp(weight - log_max);
+        norm += weight;
+    }
+    for (double& weight : window.weight_vector)
+    {
+        weight /= norm;
+    }
+    return window;
+}
+
+/**
+ * \brief Root of the cluster of a node, with path halving
+ * \param[in] parent_vector parent of each node
+ * \param[in] node node
+ */
+static NodeLabel find_root(vector<NodeLabel>& parent_vector, NodeLabel node)
+{
+    while (parent_vector[node] != node)
+    {
+        parent_vector[node] = parent_vector[parent_vector[node]];
+        node = parent_vector[node];
+    }
+    return node;
+}
+
+/**
+ * \brief Transmissibility of an edge for the SIR model with constant rates
+ * \param[in] transmission_rate rate of transmission per edge
+ * \param[in] recovery_rate rate of recovery
+ */
+double transmissibility(double transmission_rate, double recovery_rate)
+{
+    return transmission_rate/(transmission_rate + recovery_rate);
+}
+
+/**
+ * \brief Final size statistics of the SIR model from a bond percolation on
+ *  the network, for a list of transmissibilities.
+ *
+ *  For each replicate, the edges are occupied one by one in a random order
+ *  (Newman-Ziff algorithm) and the clusters are merged with a union-find
+ *  structure. The observables with m occupied edges are averaged with the
+ *  binomial weights of each transmissibility T, so that every T is obtained
+ *  from the same pass over the edges.
+ *
+ *  The final size of an outbreak from a random seed is the size of the
+ *  cluster of a random node. The mapping is exact when the infectious period
+ *  is the same for all nodes; with the exponential infectious period of the
+ *  SIR model (T = transmission/(transmission+recovery)), the edges of a node
+ *  are correlated and the percolation only gives the expected size of large
+ *  outbreaks (largest component) and an approximation of the distribution.
+ *
+ * \param[in] network network
+ * \param[in] transmissibility_vector occupation probabilities of the edges
+ * \param[in] replicate number of random edge orders
+ * \param[in] seed seed for the random number generators
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ */
+PercolationEstimate bond_percolation(const Network& network,
+        const vector<double>& transmissibility_vector,
+        unsigned int replicate, unsigned int seed, unsigned int thread_number)
+{
+    if (replicate == 0)
+    {
+        throw invalid_argument("At least one replicate is needed");
+    }
+    size_t size = network.size();
+    size_t number = transmissibility_vector.size();
+
+    //edge list without self-loops, which never join clusters
+    vector<pair<NodeLabel,NodeLabel>> edge_list;
+    for (NodeLabel node = 0; node < size; node++)
+    {
+        for (NodeLabel neighbor : network.get_neighbor_vector(node))
+        {
+            if (node < neighbor)
+            {
+                edge_list.emplace_back(node, neighbor);
+            }
+        }
+    }
+    size_t edge_number = edge_list.size();
+
+    //binomial weights, in order of their first number of occupied edges
+    vector<BinomialWindow> window_vector;
+    for (double occupation : transmissibility_vector)
+    {
+        window_vector.push_back(binomial_window(edge_number, occupation));
+    }
+    vector<size_t> order_vector(number);
+    for (size_t t = 0; t < number; t++)
+    {
+        order_vector[t] = t;
+    }
+    sort(order_vector.begin(), order_vector.end(), [&](size_t t1, size_t t2)
+        {return window_vector[t1].first < window_vector[t2].first;});
+
+    //first and second moment of the final size, largest component, for
+    //each replicate and transmissibility
+    vector<vector<double>> moment_vector(replicate,
+            vector<double>(3*number, 0.));
+    parallel_for(replicate, thread_number, [&](size_t r)
+    {
+        RNGType gen(seed, r);
+        vector<pair<NodeLabel,NodeLabel>> order(edge_list);
+        shuffle(order.begin(), order.end(), gen);
+        vector<NodeLabel> parent_vector(size);
+        vector<size_t> cluster_size_vector(size, 1);
+        for (NodeLabel node = 0; node < size; node++)
+        {
+            parent_vector[node] = node;
+        }
+        double square_sum = size; //sum of the squared cluster sizes
+        double cube_sum = size;
+        size_t largest_size = (size > 0) ? 1 : 0;
+
+        vector<double>& moment = moment_vector[r];
+        vector<size_t> active_vector; //transmissibilities with weight at m
+        size_t next = 0;
+        for (size_t m = 0; m <= edge_number; m++)
+        {
+            if (m > 0)
+            {
+                //occupy the m-th edge
+                NodeLabel root1 = find_root(parent_vector, order[m-1].first);
+                NodeLabel root2 = find_root(parent_vector, order[m-1].second);
+                if (root1 != root2)
+                {
+                    double size1 = cluster_size_vector[root1];
+                    double size2 = cluster_size_vector[root2];
+                    if (size1 < size2)
+                    {
+                        swap(root1, root2);
+                    }
+                    parent_vector[root2] = root1;
+                    cluster_size_vector[root1] += cluster_size_vector[root2];
+                    square_sum += 2*size1*size2;
+                    cube_sum += 3*size1*size2*(size1 + size2);
+                    largest_size = max(largest_size,
+                            cluster_size_vector[root1]);
+                }
+            }
+            while (next < number and window_vector[order_vector[next]].first
+                    == m)
+            {
+                active_vector.push_back(order_vector[next]);
+                next++;
+            }
+            for (size_t i = 0; i < active_vector.size(); )
+            {
+                size_t t = active_vector[i];
+                const BinomialWindow& window = window_vector[t];
+                double weight = window.weight_vector[m - window.first];
+                moment[3*t] += weight*square_sum/size/size;
+                moment[3*t+1] += weight*cube_sum/size/size/size;
+                moment[3*t+2] += weight*largest_size/size;
+                if (m + 1 == window.first + window.weight_vector.size())
+                {
+                    active_vector[i] = active_vector.back();
+                    active_vector.pop_back();
+                }
+                else
+                {
+                    i++;
+                }
+            }
+        }
+    });
+
+    PercolationEstimate estimate;
+    estimate.mean_final_size_vector.assign(number, 0.);
+    estimate.final_size_std_vector.assign(number, 0.);
+    estimate.largest_component_vector.assign(number, 0.);
+    for (size_t t = 0; t < number; t++)
+    {
+        double second_moment = 0;
+        for (size_t r = 0; r < replicate; r++)
+        {
+            estimate.mean_final_size_vector[t] += moment_vector[r][3*t];
+            second_moment += moment_vector[r][3*t+1];
+            estimate.largest_component_vector[t] += moment_vector[r][3*t+2];
+        }
+        estimate.mean_final_size_vector[t] /= replicate;
+        second_moment /= replicate;
+        estimate.largest_component_vector[t] /= replicate;
+        estimate.final_size_std_vector[t] = sqrt(max(second_moment
+                - pow(estimate.mean_final_size_vector[t], 2), 0.));
+    }
+    return estimate;
+}
+
+}//end of namespace net
@@ -0,0 +1,36 @@
+/**
+* \file percolation.hpp
+* \brief Header file for the bond percolation estimates of SIR final sizes
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#ifndef PERCOLATION_HPP_
+#define PERCOLATION_HPP_
+
+#include <Network.hpp>
+#include <vector>
+
+namespace net
+{//start of namespace net
+
+//Define structure for the result of the bond percolation, one entry per
+//transmissibility
+struct PercolationEstimate
+{
+    std::vector<double> mean_final_size_vector; //from a random seed
+    std::vector<double> final_size_std_vector; //from a random seed
+    std::vector<double> largest_component_vector; //fraction of the nodes
+};
+
+double transmissibility(double transmission_rate, double recovery_rate);
+
+PercolationEstimate bond_percolation(const Network& network,
+        const std::vector<double>& transmissibility_vector,
+        unsigned int replicate, unsigned int seed,
+        unsigned int thread_number = 1);
+
+}//end of namespace net
+
+#endif /* PERCOLATION_HPP_ */
@@ -0,0 +1,186 @@
+/**
+* \file splitting.cpp
+* \brief Functions for the rare-event sampling of spreading processes
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#include <splitting.hpp>
+#include <parallel.hpp>
+#include <stdexcept>
+#include <cmath>
+#include <memory>
+
+using namespace std;
+
+namespace net
+{//start of namespace net
+
+/**
+ * \brief Observable on which the levels are defined
+ * \param[in] process spreading process
+ * \param[in] cumulative if true, number of infected and recovered nodes,
+ *  otherwise number of infected nodes
+ */
+static size_t splitting_observable(const SpreadingProcess& process,
+        bool cumulative)
+{
+    return cumulative ?
+        process.get_Inode_number() + process.get_Rnode_number() :
+        process.get_Inode_number();
+}
+
+/**
+ * \brief Evolve a process until the observable reaches a level
+ * \param[in] process spreading process
+ * \param[in] level level to reach
+ * \param[in] cumulative type of observable
+ * \param[in] end_time time after which the trajectory is discarded
+ * \return true if the level is reached before absorption and end_time
+ */
+static bool reach_level(SpreadingProcess& process, size_t level,
+        bool cumulative, double end_time)
+{
+    while (splitting_observable(process, cumulative) < level)
+    {
+        if (process.is_absorbed() or process.get_current_time() > end_time)
+        {
+            return false;
+        }
+        process.next_state();
+    }
+    return true;
+}
+
+/**
+ * \brief Estimate the probability that the observable (number of infected
+ *  nodes, or number of infected and recovered nodes if cumulative) reaches
+ *  the last level before absorption, starting from the state of process.
+ *
+ *  Fixed-effort multilevel splitting: a population of trajectories is
+ *  evolved until it reaches the next level or dies; the fraction of
+ *  survivors estimates the conditional probability of the level, and the
+ *  population is regenerated by forking uniformly chosen survivors. All
+ *  trajectories of a stage then carry the same weight, the product of the
+ *  conditional probabilities, which is an unbiased estimate. The variance is
+ *  estimated from independent replicates.
+ * \param[in] process initial state
+ * \param[in] level_vector increasing levels of the observable
+ * \param[in] population_size number of trajectories at each level
+ * \param[in] replicate number of independent estimates
+ * \param[in] seed seed for the random number generators
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ * \param[in] cumulative type of observable
+ * \param[in] max_time trajectories not reaching the last level within this
+ *  time are discarded
+ */
+SplittingEstimate multilevel_splitting(const SpreadingProcess& process,
+        const vector<size_t>& level_vector, unsigned int population_size,
+        unsigned int replicate, unsigned int seed, unsigned int thread_number,
+        bool cumulative, double max_time)
+{
+    if (population_size == 0 or replicate == 0)
+    {
+        throw invalid_argument("Population size and replicate must be > 0");
+    }
+    for (size_t k = 1; k < level_vector.size(); k++)
+    {
+        if (level_vector[k] <= level_vector[k-1])
+        {
+            throw invalid_argument("Levels must be increasing");
+        }
+    }
+    double end_time = process.get_current_time() + max_time;
+    SplittingEstimate result;
+    result.estimate_vector.assign(replicate, 1.);
+    result.level_probability_vector.assign(level_vector.size(), 0.);
+
+    RNGType gen(seed);
+    for (unsigned int r = 0; r < replicate; r++)
+    {
+        //initial population
+        vector<unsigned int> seed_vector(population_size);
+        for (auto& fork_seed : seed_vector)
+        {
+            fork_seed = gen();
+        }
+        vector<unique_ptr<SpreadingProcess>> population(population_size);
+        parallel_for(population_size, thread_number, [&](size_t i)
+            {
+                population[i].reset(
+                    new SpreadingProcess(process.fork(seed_vector[i])));
+                population[i]->set_trajectory_recording(false);
+            });
+
+        for (size_t k = 0; k < level_vector.size(); k++)
+        {
+            //evolve each trajectory up to the level
+            vector<char> success_vector(population_size, 0);
+            parallel_for(population_size, thread_number, [&](size_t i)
+                {
+                    success_vector[i] = reach_level(*population[i],
+                            level_vector[k], cumulative, end_time);
+                });
+            vector<size_t> survivor_vector;
+            for (size_t i = 0; i < population_size; i++)
+            {
+                if (success_vector[i])
+                {
+                    survivor_vector.push_back(i);
+                }
+            }
+            double level_probability = (1.*survivor_vector.size())/
+                population_size;
+            result.level_probability_vector[k] += level_probability/replicate;
+            result.estimate_vector[r] *= level_probability;
+            if (survivor_vector.empty())
+            {
+                //the other levels are never reached
+                break;
+            }
+
+            //resample the population among the survivors
+            if (k+1 < level_vector.size())
+            {
+                vector<size_t> parent_vector(population_size);
+                for (unsigned int i = 0; i < population_size; i++)
+                {
+                    parent_vector[i] = survivor_vector[
+                        floor(ldexp(gen(), -32)*survivor_vector.size())];
+                    seed_vector[i] = gen();
+                }
+                vector<unique_ptr<SpreadingProcess>> new_population(
+                        population_size);
+                parallel_for(population_size, thread_number, [&](size_t i)
+                    {
+                        new_population[i].reset(new SpreadingProcess(
+                            population[parent_vector[i]]->fork(
+                                seed_vector[i])));
+                    });
+                population.swap(new_population);
+            }
+        }
+    }
+
+    //statistics over the replicates
+    result.probability = 0.;
+    for (double estimate : result.estimate_vector)
+    {
+        result.probability += estimate/replicate;
+    }
+    result.variance = numeric_limits<double>::quiet_NaN();
+    if (replicate > 1)
+    {
+        result.variance = 0.;
+        for (double estimate : result.estimate_vector)
+        {
+            result.variance += (estimate - result.probability)*
+                (estimate - result.probability);
+        }
+        result.variance /= (replicate - 1.)*replicate;
+    }
+    return result;
+}
+
+}//end of namespace net
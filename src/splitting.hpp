@@ -0,0 +1,38 @@
+/**
+* \file splitting.hpp
+* \brief Header file for the rare-event sampling of spreading processes
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#ifndef SPLITTING_HPP_
+#define SPLITTING_HPP_
+
+#include <SpreadingProcess.hpp>
+#include <vector>
+#include <limits>
+
+namespace net
+{//start of namespace net
+
+//Define structure for the result of the multilevel splitting
+struct SplittingEstimate
+{
+    double probability; //mean of the replicate estimates
+    double variance; //variance of the mean, estimated from the replicates
+    std::vector<double> estimate_vector; //estimate of each replicate
+    std::vector<double> level_probability_vector; //mean conditional
+                                                  //probability of each level
+};
+
+SplittingEstimate multilevel_splitting(const SpreadingProcess& process,
+        const std::vector<std::size_t>& level_vector,
+        unsigned int population_size, unsigned int replicate,
+        unsigned int seed, unsigned int thread_number = 1,
+        bool cumulative = false,
+        double max_time = std::numeric_limits<double>::infinity());
+
+}//end of namespace net
+
+#endif /* SPLITTING_HPP_ */
@@ -0,0 +1,140 @@
+/**
+* \file sweep.cpp
+* \brief Functions for the parameter sweeps of spreading processes
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#include <sweep.hpp>
+#include <parallel.hpp>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace net
+{//start of namespace net
+
+/**
+ * \brief Simulate replicates of a process for a list of rates, reusing the
+ *  network and the propensity groups of one copy of the process per thread.
+ *
+ *  For each rate and replicate, the nodes of Inode_vector are infected and
+ *  the process evolves for time_variation. Replicate j of rate i uses the seed
+ *  seed + i*replicate + j, so that the results do not depend on the number
+ *  of threads.
+ *
+ * \param[in] process prototype of the process; its state is not used
+ * \param[in] rate_vector rates (transmission, recovery, waning immunity)
+ * \param[in] Inode_vector nodes infected initially
+ * \param[in] replicate number of replicates per rate
+ * \param[in] seed seed of the first replicate
+ * \param[in] time_variation duration of each replicate
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ */
+SweepResult rate_sweep(const SpreadingProcess& process,
+        const vector<RateTuple>& rate_vector,
+        const vector<NodeLabel>& Inode_vector, unsigned int replicate,
+        unsigned int seed, double time_variation, unsigned int thread_number)
+{
+    SweepResult result;
+    result.prevalence_vector.assign(rate_vector.size()*replicate, 0.);
+    result.final_size_vector.assign(rate_vector.size()*replicate, 0.);
+    if (thread_number == 0)
+    {
+        thread_number = max(thread::hardware_concurrency(), 1u);
+    }
+    unsigned int worker_number = max(min(thread_number, replicate), 1u);
+
+    //each worker owns a copy and handles the replicates j = worker mod
+    //worker_number of every rate
+    parallel_for(worker_number, worker_number, [&](size_t worker)
+    {
+        SpreadingProcess copy = process.clone();
+        copy.set_trajectory_recording(false);
+        copy.set_infection_recording(false);
+        copy.reset();
+        for (size_t i = 0; i < rate_vector.size(); i++)
+        {
+            copy.set_rates(get<0>(rate_vector[i]), get<1>(rate_vector[i]),
+                    get<2>(rate_vector[i]));
+            for (size_t j = worker; j < replicate; j += worker_number)
+            {
+                size_t index = i*replicate + j;
+                copy.initialize(Inode_vector, seed + index);
+                copy.evolve(time_variation);
+                result.prevalence_vector[index] =
+                    (1.*copy.get_Inode_number())/copy.get_size();
+                result.final_size_vector[index] =
+                    (1.*copy.get_Rnode_number())/copy.get_size();
+                copy.reset();
+            }
+        }
+    });
+    return result;
+}
+
+/**
+ * \brief Evolve independent replicates of a quasi-stationary process and
+ *  merge their statistics.
+ *
+ *  Each replicate is a fork of the prototype: it shares the network, starts
+ *  from the state and history of the prototype, and has its own random
+ *  number generator (seed + j for replicate j) and history. The statistics
+ *  of the prototype are discarded; the relaxation time is the one of the
+ *  prototype, measured from its initialization. The occupation times and
+ *  absorptions of all replicates are summed before computing the estimates.
+ *
+ * \param[in] process initialized prototype of the process
+ * \param[in] replicate number of replicates
+ * \param[in] seed seed of the first replicate
+ * \param[in] time_variation duration of each replicate
+ * \param[in] thread_number number of threads (0: hardware concurrency)
+ */
+QSReplicateResult qs_replicates(const QSSpreadingProcess& process,
+        unsigned int replicate, unsigned int seed, double time_variation,
+        unsigned int thread_number)
+{
+    if (process.get_Inode_number() == 0)
+    {
+        throw invalid_argument("The prototype must be initialized");
+    }
+    vector<vector<double>> occupation_time_matrix(replicate);
+    vector<size_t> absorption_number_vector(replicate, 0);
+    QSReplicateResult result;
+    result.mean_prevalence_vector.assign(replicate, 0.);
+    parallel_for(replicate, thread_number, [&](size_t j)
+    {
+        QSSpreadingProcess copy = process.fork(seed + j);
+        copy.reset_statistics();
+        copy.evolve(time_variation);
+        occupation_time_matrix[j] = copy.get_occupation_time_vector();
+        absorption_number_vector[j] = copy.get_absorption_number();
+        result.mean_prevalence_vector[j] =
+            copy.get_qs_estimate().mean_prevalence;
+    });
+
+    //merge the statistics
+    vector<double> occupation_time_vector;
+    size_t absorption_number = 0;
+    for (size_t j = 0; j < replicate; j++)
+    {
+        if (occupation_time_matrix[j].size() > occupation_time_vector.size())
+        {
+            occupation_time_vector.resize(occupation_time_matrix[j].size(),
+                0.);
+        }
+        for (size_t n = 0; n < occupation_time_matrix[j].size(); n++)
+        {
+            occupation_time_vector[n] += occupation_time_matrix[j][n];
+        }
+        absorption_number += absorption_number_vector[j];
+    }
+    result.estimate = qs_estimate(occupation_time_vector, absorption_number,
+        process.get_size());
+    return result;
+}
+
+}//end of namespace net
@@ -0,0 +1,53 @@
+/**
+* \file sweep.hpp
+* \brief Header file for the parameter sweeps of spreading processes
+* \author Guillaume St-Onge
+* \version 1.0
+* \date 18/10/2026
+*/
+
+#ifndef SWEEP_HPP_
+#define SWEEP_HPP_
+
+#include <SpreadingProcess.hpp>
+#include <QSSpreadingProcess.hpp>
+#include <vector>
+#include <tuple>
+#include <limits>
+
+namespace net
+{//start of namespace net
+
+//Define new types
+typedef std::tuple<double,double,double> RateTuple; //transmission, recovery,
+                                                    //waning immunity
+
+//Define structure for the result of a sweep, indexed by
+//rate_index*replicate + replicate_index
+struct SweepResult
+{
+    std::vector<double> prevalence_vector; //fraction of I nodes at the end
+    std::vector<double> final_size_vector; //fraction of R nodes at the end
+};
+
+//Define structure for the result of quasi-stationary replicates
+struct QSReplicateResult
+{
+    QSEstimate estimate; //from the merged occupation times
+    std::vector<double> mean_prevalence_vector; //per replicate
+};
+
+SweepResult rate_sweep(const SpreadingProcess& process,
+        const std::vector<RateTuple>& rate_vector,
+        const std::vector<NodeLabel>& Inode_vector, unsigned int replicate,
+        unsigned int seed,
+        double time_variation = std::numeric_limits<double>::infinity(),
+        unsigned int thread_number = 1);
+
+QSReplicateResult qs_replicates(const QSSpreadingProcess& process,
+        unsigned int replicate, unsigned int seed, double time_variation,
+        unsigned int thread_number = 1);
+
+}//end of namespace net
+
+#endif /* SWEEP_HPP_ */